@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Matching engine of simex on one instrument, each operation is one quote update followed by one incoming order:
+//   simex.match.gfd            limit orders that rest what they can not fill
+//   simex.match.ioc            limit orders that cancel what they can not fill
+//   simex.match.all_gfd        all-or-none limit orders, half of them larger than the quote can fill
+// Before timing, the statuses of orders that the book can and can not fill at once are checked, exits 1 if wrong.
+// usage: bench_matching [iterations]
+
+#include <chrono>
+#include <cstdio>
+
+#include "../cpp/matching_engine.h"
+
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::wingchun::simex;
+
+static Quote make_quote(int64_t ask_volume) {
+  Quote quote = {};
+  quote.instrument_id = "600000";
+  quote.exchange_id = EXCHANGE_SSE;
+  quote.bid_price[0] = 9.99;
+  quote.bid_volume[0] = ask_volume;
+  quote.ask_price[0] = 10.01;
+  quote.ask_volume[0] = ask_volume;
+  return quote;
+}
+
+static Order make_order(uint64_t order_id, int64_t volume, TimeCondition time_condition,
+                        VolumeCondition volume_condition) {
+  Order order = {};
+  order.order_id = order_id;
+  order.side = Side::Buy;
+  order.price_type = PriceType::Limit;
+  order.limit_price = 10.01;
+  order.volume = volume;
+  order.time_condition = time_condition;
+  order.volume_condition = volume_condition;
+  return order;
+}
+
+/**
+ * Match one order against a fresh book quoted with ask_volume, then check its status and what rests in the book.
+ */
+static bool check(const char *name, int64_t ask_volume, const Order &order, OrderStatus status, size_t resting) {
+  OrderBook book;
+  std::vector<Fill> fills = {};
+  book.update_quote(make_quote(ask_volume), fills);
+  MatchTerms terms(order);
+  auto volume_traded =
+      book.match(order.order_id, order.side, terms.limit, order.volume, terms.rest, terms.all_or_none, fills);
+  auto result = terms.get_status(order.volume, volume_traded);
+  if (result != status or book.resting_count() != resting) {
+    fmt::print(stderr, "check {} failed: status {} resting {}, expects status {} resting {}\n", name, int(result),
+               book.resting_count(), int(status), resting);
+    return false;
+  }
+  return true;
+}
+
+template <typename MakeOrder> void throughput(const char *name, size_t iterations, MakeOrder &&make) {
+  OrderBook book;
+  std::vector<Fill> fills = {};
+  size_t filled = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    fills.clear();
+    book.update_quote(make_quote(500), fills);
+    auto order = make(i);
+    MatchTerms terms(order);
+    auto volume_traded =
+        book.match(order.order_id, order.side, terms.limit, order.volume, terms.rest, terms.all_or_none, fills);
+    filled += terms.get_status(order.volume, volume_traded) == OrderStatus::Filled;
+    // keep the book from growing without bound when quotes can not fill what rests
+    if (book.resting_count() > 1000) {
+      book = OrderBook();
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  auto ns_per_op = double(elapsed.count()) / std::max<size_t>(iterations, 1);
+  fmt::print(R"({{"name":"{}","iterations":{},"ns_per_op":{:.2f},"ops_per_sec":{:.0f},"filled":{}}})"
+             "\n",
+             name, iterations, ns_per_op, ns_per_op > 0 ? 1e9 / ns_per_op : 0, filled);
+}
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  bool passed = true;
+  passed &= check("gfd.partial", 100, make_order(1, 300, TimeCondition::GFD, VolumeCondition::Any),
+                  OrderStatus::PartialFilledActive, 1);
+  passed &= check("ioc.partial", 100, make_order(1, 300, TimeCondition::IOC, VolumeCondition::Any),
+                  OrderStatus::PartialFilledNotActive, 0);
+  passed &= check("all_gfd.short", 100, make_order(1, 300, TimeCondition::GFD, VolumeCondition::All),
+                  OrderStatus::Cancelled, 0);
+  passed &= check("all_gfd.enough", 500, make_order(1, 300, TimeCondition::GFD, VolumeCondition::All),
+                  OrderStatus::Filled, 0);
+  if (not passed) {
+    return 1;
+  }
+
+  throughput("simex.match.gfd", iterations,
+             [](size_t i) { return make_order(i + 1, 100 * (i % 10 + 1), TimeCondition::GFD, VolumeCondition::Any); });
+  throughput("simex.match.ioc", iterations,
+             [](size_t i) { return make_order(i + 1, 100 * (i % 10 + 1), TimeCondition::IOC, VolumeCondition::Any); });
+  throughput("simex.match.all_gfd", iterations,
+             [](size_t i) { return make_order(i + 1, 100 * (i % 10 + 1), TimeCondition::GFD, VolumeCondition::All); });
+  return 0;
+}
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "marketdata_simex.h"
+#include "trader_simex.h"
+
+#include <kungfu/wingchun/extension.h>
+
+KUNGFU_EXTENSION() {
+  KUNGFU_DEFINE_MD(kungfu::wingchun::simex::MarketDataSimex);
+  KUNGFU_DEFINE_TD(kungfu::wingchun::simex::TraderSimex);
+}
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sstream>
+
+#include <kungfu/yijinjing/time.h>
+
+#include "marketdata_simex.h"
+
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::yijinjing;
+
+namespace kungfu::wingchun::simex {
+static constexpr int64_t GENERATE_INTERVAL = time_unit::NANOSECONDS_PER_MILLISECOND;
+/** messages owed after a stall are capped at this many seconds of the current rate */
+static constexpr double MAX_BACKLOG_SECONDS = 0.1;
+static constexpr double AGGRESSIVE_RATIO = 0.3;
+static constexpr int64_t PRICE_LIMIT_RATIO = 10; // percent
+
+struct MDConfiguration {
+  std::string instruments;
+  int universe;
+  double rate;
+  std::string rate_profile;
+  bool l2;
+  int quote_every;
+  int shards;
+  uint64_t seed;
+};
+
+void from_json(const nlohmann::json &j, MDConfiguration &c) {
+  c.instruments = j.value("instruments", "");
+  c.universe = j.value("universe", 100);
+  c.rate = j.value("rate", 10000.0);
+  c.rate_profile = j.value("rate_profile", "");
+  c.l2 = j.value("l2", true);
+  c.quote_every = j.value("quote_every", 1);
+  c.shards = j.value("shards", 0);
+  c.seed = j.value("seed", 0);
+}
+
+MarketDataSimex::MarketDataSimex(broker::BrokerVendor &vendor) : MarketData(vendor) { KUNGFU_SETUP_LOG(); }
+
+void MarketDataSimex::on_start() {
+  MDConfiguration config = get_config().empty() ? nlohmann::json::object() : nlohmann::json::parse(get_config());
+  random_.seed(config.seed);
+  rate_ = std::max(config.rate, 0.0);
+  l2_ = config.l2;
+  quote_every_ = std::max(config.quote_every, 1);
+  trading_day_ = time::strftime(get_vendor().get_trading_day(), KUNGFU_TRADING_DAY_FORMAT);
+
+  // profile of "HH:MM[:SS]=rate" points in local time, each rate holds until the next point
+  std::stringstream points(config.rate_profile);
+  std::string point;
+  while (std::getline(points, point, ',')) {
+    int hour = 0, minute = 0, second = 0;
+    double rate = 0;
+    if (std::sscanf(point.c_str(), "%d:%d:%d=%lf", &hour, &minute, &second, &rate) != 4 and
+        (second = 0, std::sscanf(point.c_str(), "%d:%d=%lf", &hour, &minute, &rate) != 3)) {
+      SPDLOG_WARN("invalid rate profile point [{}]", point);
+      continue;
+    }
+    rate_profile_.push_back({(hour * 60 + minute) * 60 + second, std::max(rate, 0.0)});
+  }
+  std::sort(rate_profile_.begin(), rate_profile_.end(),
+            [](const RateSegment &a, const RateSegment &b) { return a.second_of_day < b.second_of_day; });
+
+  std::stringstream instruments(config.instruments);
+  std::string instrument;
+  while (std::getline(instruments, instrument, ',')) {
+    auto dot = instrument.find('.');
+    if (dot == std::string::npos) {
+      SPDLOG_WARN("invalid instrument [{}], expect instrument_id.exchange_id", instrument);
+      continue;
+    }
+    add_book(instrument.substr(dot + 1).c_str(), instrument.substr(0, dot).c_str());
+  }
+  for (int i = 0; config.instruments.empty() and i < config.universe; i++) {
+    add_book(EXCHANGE_SSE, std::to_string(600000 + i).c_str());
+  }
+
+  if (config.shards > 0) {
+    request_md_shards(config.shards);
+  }
+  add_time_interval(GENERATE_INTERVAL, [&](const event_ptr &event) { generate(); });
+  SPDLOG_INFO("generating market data of {} instruments at {} messages/s, l2 {}, {} rate profile points",
+              books_.size(), rate_, l2_, rate_profile_.size());
+  update_broker_state(BrokerState::Ready);
+}
+
+void MarketDataSimex::on_trading_day(const event_ptr &event, int64_t daytime) {
+  trading_day_ = time::strftime(daytime, KUNGFU_TRADING_DAY_FORMAT);
+}
+
+bool MarketDataSimex::subscribe(const std::vector<InstrumentKey> &instrument_keys) {
+  for (const auto &key : instrument_keys) {
+    add_book(key.exchange_id, key.instrument_id);
+  }
+  return true;
+}
+
+void MarketDataSimex::add_book(const char *exchange_id, const char *instrument_id) {
+  auto key = hash_instrument(exchange_id, instrument_id);
+  if (not book_keys_.emplace(key).second) {
+    return;
+  }
+  Book book = {};
+  book.key.key = key;
+  book.key.instrument_id = instrument_id;
+  book.key.exchange_id = exchange_id;
+  book.key.instrument_type = get_instrument_type(exchange_id, instrument_id);
+  book.price_tick = 0.01;
+  book.lot = book.key.instrument_type == InstrumentType::Stock ? 100 : 1;
+  book.pre_close = std::uniform_int_distribution<int64_t>(500, 10000)(random_);
+  book.best_bid = book.pre_close - 1;
+  book.last_price = book.pre_close;
+  book.open_price = book.pre_close;
+  book.high_price = book.pre_close;
+  book.low_price = book.pre_close;
+  for (size_t i = 0; i < DEPTH; i++) {
+    refill_level(book, book.bid_volume[i]);
+    refill_level(book, book.ask_volume[i]);
+  }
+  books_.push_back(book);
+}
+
+double MarketDataSimex::get_rate(int64_t nanotime) const {
+  if (rate_profile_.empty()) {
+    return rate_;
+  }
+  std::time_t seconds = nanotime / time_unit::NANOSECONDS_PER_SECOND;
+  std::tm local = {};
+  localtime_r(&seconds, &local);
+  int64_t second_of_day = (local.tm_hour * 60 + local.tm_min) * 60 + local.tm_sec;
+  auto rate = rate_;
+  for (const auto &segment : rate_profile_) {
+    if (segment.second_of_day > second_of_day) {
+      break;
+    }
+    rate = segment.rate;
+  }
+  return rate;
+}
+
+void MarketDataSimex::generate() {
+  auto nano = time::now_in_nano();
+  if (last_generate_time_ == 0 or books_.empty()) {
+    last_generate_time_ = nano;
+    return;
+  }
+  auto rate = get_rate(nano);
+  auto elapsed = static_cast<double>(nano - last_generate_time_) / time_unit::NANOSECONDS_PER_SECOND;
+  budget_ = std::min(budget_ + rate * elapsed, std::max(rate * MAX_BACKLOG_SECONDS, 1.0));
+  last_generate_time_ = nano;
+  std::uniform_int_distribution<size_t> pick(0, books_.size() - 1);
+  while (budget_ >= 1) {
+    budget_ -= generate_tick(books_[pick(random_)]);
+  }
+}
+
+int64_t MarketDataSimex::generate_tick(Book &book) {
+  auto side = random_() % 2 == 0 ? Side::Buy : Side::Sell;
+  bool buy = side == Side::Buy;
+  if (not l2_) {
+    auto step = static_cast<int64_t>(random_() % 3) - 1;
+    auto limit = book.pre_close * PRICE_LIMIT_RATIO / 100;
+    book.best_bid = std::clamp(book.best_bid + step, book.pre_close - limit, book.pre_close + limit - 1);
+    book.last_price = buy ? book.best_bid + 1 : book.best_bid;
+    book.high_price = std::max(book.high_price, book.last_price);
+    book.low_price = std::min(book.low_price, book.last_price);
+    book.volume += book.lot;
+    book.turnover += book.last_price * book.price_tick * book.lot;
+    write_quote(book);
+    return 1;
+  }
+
+  int64_t written = 0;
+  int64_t volume = book.lot * static_cast<int64_t>(1 + random_() % 10);
+  if (std::uniform_real_distribution<double>(0, 1)(random_) < AGGRESSIVE_RATIO) {
+    auto &levels = buy ? book.ask_volume : book.bid_volume;
+    auto &other = buy ? book.bid_volume : book.ask_volume;
+    auto price = buy ? book.best_bid + 1 : book.best_bid;
+    auto traded = std::min(volume, levels[0]);
+    write_entrust(book, side, price, volume);
+    write_transaction(book, side, price, traded);
+    written += 2;
+    levels[0] -= traded;
+    book.last_price = price;
+    book.high_price = std::max(book.high_price, price);
+    book.low_price = std::min(book.low_price, price);
+    book.volume += traded;
+    book.turnover += price * book.price_tick * traded;
+    // the level is used up, price moves one tick unless it hits the price limit
+    auto limit = book.pre_close * PRICE_LIMIT_RATIO / 100;
+    auto best_bid = book.best_bid + (buy ? 1 : -1);
+    if (levels[0] == 0 and best_bid >= book.pre_close - limit and best_bid < book.pre_close + limit) {
+      book.best_bid = best_bid;
+      std::move(levels + 1, levels + DEPTH, levels);
+      refill_level(book, levels[DEPTH - 1]);
+      std::move_backward(other, other + DEPTH - 1, other + DEPTH);
+      other[0] = volume - traded > 0 ? volume - traded : book.lot;
+    } else if (levels[0] == 0) {
+      refill_level(book, levels[0]);
+    }
+  } else {
+    auto level = random_() % 5;
+    auto price = buy ? book.best_bid - static_cast<int64_t>(level) : book.best_bid + 1 + static_cast<int64_t>(level);
+    (buy ? book.bid_volume : book.ask_volume)[level] += volume;
+    write_entrust(book, side, price, volume);
+    written++;
+  }
+  if (++book.entrust_count % quote_every_ == 0) {
+    write_quote(book);
+    written++;
+  }
+  return written;
+}
+
+void MarketDataSimex::write_quote(const Book &book) {
+  auto writer = get_md_writer(book.key.exchange_id, book.key.instrument_id);
+  Quote &quote = writer->open_data<Quote>(0);
+  quote.trading_day = trading_day_.c_str();
+  quote.data_time = time::now_in_nano();
+  quote.instrument_id = book.key.instrument_id;
+  quote.exchange_id = book.key.exchange_id;
+  quote.instrument_type = book.key.instrument_type;
+  quote.pre_close_price = book.pre_close * book.price_tick;
+  quote.last_price = book.last_price * book.price_tick;
+  quote.volume = book.volume;
+  quote.turnover = book.turnover;
+  quote.open_price = book.open_price * book.price_tick;
+  quote.high_price = book.high_price * book.price_tick;
+  quote.low_price = book.low_price * book.price_tick;
+  quote.upper_limit_price = (book.pre_close + book.pre_close * PRICE_LIMIT_RATIO / 100) * book.price_tick;
+  quote.lower_limit_price = (book.pre_close - book.pre_close * PRICE_LIMIT_RATIO / 100) * book.price_tick;
+  for (size_t i = 0; i < DEPTH; i++) {
+    quote.bid_price[i] = (book.best_bid - static_cast<int64_t>(i)) * book.price_tick;
+    quote.ask_price[i] = (book.best_bid + 1 + static_cast<int64_t>(i)) * book.price_tick;
+    quote.bid_volume[i] = book.bid_volume[i];
+    quote.ask_volume[i] = book.ask_volume[i];
+  }
+  writer->close_data();
+}
+
+void MarketDataSimex::write_entrust(const Book &book, Side side, int64_t price, int64_t volume) {
+  auto writer = get_md_writer(book.key.exchange_id, book.key.instrument_id);
+  Entrust &entrust = writer->open_data<Entrust>(0);
+  entrust.trading_day = trading_day_.c_str();
+  entrust.data_time = time::now_in_nano();
+  entrust.instrument_id = book.key.instrument_id;
+  entrust.exchange_id = book.key.exchange_id;
+  entrust.instrument_type = book.key.instrument_type;
+  entrust.price = price * book.price_tick;
+  entrust.volume = volume;
+  entrust.side = side;
+  entrust.price_type = PriceType::Limit;
+  entrust.main_seq = 1;
+  entrust.seq = ++seq_;
+  entrust.orig_order_no = seq_;
+  entrust.biz_index = seq_;
+  writer->close_data();
+}
+
+void MarketDataSimex::write_transaction(const Book &book, Side side, int64_t price, int64_t volume) {
+  auto writer = get_md_writer(book.key.exchange_id, book.key.instrument_id);
+  Transaction &transaction = writer->open_data<Transaction>(0);
+  transaction.trading_day = trading_day_.c_str();
+  transaction.data_time = time::now_in_nano();
+  transaction.instrument_id = book.key.instrument_id;
+  transaction.exchange_id = book.key.exchange_id;
+  transaction.instrument_type = book.key.instrument_type;
+  transaction.price = price * book.price_tick;
+  transaction.volume = volume;
+  // the aggressor is the entrust just written, makers are not tracked by the synthetic book
+  transaction.bid_no = side == Side::Buy ? seq_ : 0;
+  transaction.ask_no = side == Side::Sell ? seq_ : 0;
+  transaction.exec_type = ExecType::Trade;
+  transaction.bs_flag = side == Side::Buy ? BsFlag::Buy : BsFlag::Sell;
+  transaction.main_seq = 1;
+  transaction.seq = ++seq_;
+  transaction.biz_index = seq_;
+  writer->close_data();
+}
+
+void MarketDataSimex::refill_level(const Book &book, int64_t &volume) {
+  volume = book.lot * std::uniform_int_distribution<int64_t>(10, 100)(random_);
+}
+} // namespace kungfu::wingchun::simex
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_SIMEX_MARKETDATA_H
+#define KUNGFU_SIMEX_MARKETDATA_H
+
+#include <random>
+
+#include <kungfu/wingchun/broker/marketdata.h>
+
+namespace kungfu::wingchun::simex {
+/**
+ * Synthetic market data generator.
+ * Each instrument of the universe keeps a 10 level book around a price that walks by ticks. Generated entrusts either
+ * add volume to a level of their own side, or hit the best level of the other side, which yields a transaction and
+ * moves the price once the level is used up. A quote snapshot of the book is written after every quote_every entrusts
+ * of the instrument, or after every tick if l2 is disabled.
+ * Messages are written through market data writers, public or shards, at a rate that follows the rate profile.
+ */
+class MarketDataSimex : public broker::MarketData {
+public:
+  explicit MarketDataSimex(broker::BrokerVendor &vendor);
+
+  void on_start() override;
+
+  void on_trading_day(const event_ptr &event, int64_t daytime) override;
+
+  bool subscribe(const std::vector<longfist::types::InstrumentKey> &instrument_keys) override;
+
+  bool subscribe_all() override { return true; }
+
+  bool unsubscribe(const std::vector<longfist::types::InstrumentKey> &instrument_keys) override { return true; }
+
+private:
+  static constexpr size_t DEPTH = 10;
+
+  struct Book {
+    longfist::types::InstrumentKey key;
+    double price_tick;
+    int64_t lot;
+    int64_t pre_close; // ticks
+    int64_t best_bid;  // ticks, best ask is one tick above
+    int64_t bid_volume[DEPTH];
+    int64_t ask_volume[DEPTH];
+    int64_t last_price;
+    int64_t open_price;
+    int64_t high_price;
+    int64_t low_price;
+    int64_t volume;
+    double turnover;
+    int64_t entrust_count;
+  };
+
+  /** rate in messages per second from the given second of day on */
+  struct RateSegment {
+    int64_t second_of_day;
+    double rate;
+  };
+
+  std::vector<Book> books_ = {};
+  std::unordered_set<uint32_t> book_keys_ = {};
+  std::vector<RateSegment> rate_profile_ = {};
+  double rate_ = 0;
+  bool l2_ = true;
+  int64_t quote_every_ = 1;
+  double budget_ = 0;
+  int64_t last_generate_time_ = 0;
+  int64_t seq_ = 0;
+  std::string trading_day_ = {};
+  std::mt19937_64 random_ = {};
+
+  void add_book(const char *exchange_id, const char *instrument_id);
+
+  [[nodiscard]] double get_rate(int64_t nanotime) const;
+
+  void generate();
+
+  int64_t generate_tick(Book &book);
+
+  void write_quote(const Book &book);
+
+  void write_entrust(const Book &book, longfist::enums::Side side, int64_t price, int64_t volume);
+
+  void write_transaction(const Book &book, longfist::enums::Side side, int64_t price, int64_t volume);
+
+  void refill_level(const Book &book, int64_t &volume);
+};
+} // namespace kungfu::wingchun::simex
+
+#endif // KUNGFU_SIMEX_MARKETDATA_H
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "matching_engine.h"
+
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+
+namespace kungfu::wingchun::simex {
+MatchTerms::MatchTerms(const Order &order) {
+  bool buy = order.side == Side::Buy;
+  bool market = order.price_type != PriceType::Limit;
+  limit = market ? (buy ? INT64_MAX : INT64_MIN) : to_ticks(order.limit_price);
+  all_or_none = order.volume_condition == VolumeCondition::All or order.price_type == PriceType::Fok;
+  rest = not market and not all_or_none and order.time_condition != TimeCondition::IOC;
+}
+
+OrderStatus MatchTerms::get_status(int64_t volume, int64_t volume_traded) const {
+  if (volume_traded == volume) {
+    return OrderStatus::Filled;
+  }
+  if (rest) {
+    return volume_traded > 0 ? OrderStatus::PartialFilledActive : OrderStatus::Pending;
+  }
+  return volume_traded > 0 ? OrderStatus::PartialFilledNotActive : OrderStatus::Cancelled;
+}
+
+int64_t OrderBook::match(uint64_t order_id, longfist::enums::Side side, int64_t limit, int64_t volume, bool rest,
+                         bool all_or_none, std::vector<Fill> &fills) {
+  bool buy = side == Side::Buy;
+  if (all_or_none and available(buy, limit, volume) < volume) {
+    return 0;
+  }
+  auto &makers = buy ? asks_ : bids_;
+  auto &quotes = buy ? quote_asks_ : quote_bids_;
+  auto quote = quotes.begin();
+  int64_t remaining = volume;
+  while (remaining > 0) {
+    while (quote != quotes.end() and quote->volume == 0) {
+      quote++;
+    }
+    bool has_quote = quote != quotes.end();
+    bool has_own = not makers.empty();
+    if (not has_quote and not has_own) {
+      break;
+    }
+    auto level = not has_own ? makers.end() : buy ? makers.begin() : std::prev(makers.end());
+    // quote liquidity is ahead of own orders at the same price, it was there before any of them
+    bool use_quote = has_quote and (not has_own or crosses(buy, quote->price, level->first));
+    int64_t price = use_quote ? quote->price : level->first;
+    if (not crosses(buy, price, limit)) {
+      break;
+    }
+    if (use_quote) {
+      auto traded = std::min(remaining, quote->volume);
+      quote->volume -= traded;
+      remaining -= traded;
+      fills.push_back({order_id, 0, price, traded});
+      continue;
+    }
+    auto &maker = level->second.front();
+    auto traded = std::min(remaining, maker.volume_left);
+    maker.volume_left -= traded;
+    remaining -= traded;
+    fills.push_back({order_id, maker.order_id, price, traded});
+    if (maker.volume_left == 0) {
+      level->second.pop_front();
+    }
+    if (level->second.empty()) {
+      makers.erase(level);
+    }
+  }
+  if (rest and not all_or_none and remaining > 0) {
+    (buy ? bids_ : asks_)[limit].push_back({order_id, remaining});
+  }
+  return volume - remaining;
+}
+
+int64_t OrderBook::cancel(uint64_t order_id, longfist::enums::Side side, int64_t price) {
+  auto &levels = side == Side::Buy ? bids_ : asks_;
+  auto level = levels.find(price);
+  if (level == levels.end()) {
+    return 0;
+  }
+  auto &queue = level->second;
+  auto it = std::find_if(queue.begin(), queue.end(), [&](const Resting &r) { return r.order_id == order_id; });
+  if (it == queue.end()) {
+    return 0;
+  }
+  auto volume_left = it->volume_left;
+  queue.erase(it);
+  if (queue.empty()) {
+    levels.erase(level);
+  }
+  return volume_left;
+}
+
+void OrderBook::update_quote(const Quote &quote, std::vector<Fill> &fills) {
+  quote_bids_.clear();
+  quote_asks_.clear();
+  for (size_t i = 0; i < 10; i++) {
+    if (quote.bid_price[i] > 0 and quote.bid_volume[i] > 0) {
+      quote_bids_.push_back({to_ticks(quote.bid_price[i]), quote.bid_volume[i]});
+    }
+    if (quote.ask_price[i] > 0 and quote.ask_volume[i] > 0) {
+      quote_asks_.push_back({to_ticks(quote.ask_price[i]), quote.ask_volume[i]});
+    }
+  }
+  auto cross_side = [&](Levels &levels, bool buy) {
+    auto &quotes = buy ? quote_asks_ : quote_bids_;
+    while (not levels.empty() and not quotes.empty()) {
+      auto level = buy ? std::prev(levels.end()) : levels.begin();
+      auto &queue = level->second;
+      while (not queue.empty()) {
+        take_quote(quotes, queue.front().order_id, buy, level->first, queue.front().volume_left, fills);
+        if (queue.front().volume_left > 0) {
+          return; // quote liquidity at this price is exhausted
+        }
+        queue.pop_front();
+      }
+      levels.erase(level);
+    }
+  };
+  cross_side(bids_, true);
+  cross_side(asks_, false);
+}
+
+size_t OrderBook::resting_count() const {
+  size_t count = 0;
+  for (const auto &levels : {&bids_, &asks_}) {
+    for (const auto &pair : *levels) {
+      count += pair.second.size();
+    }
+  }
+  return count;
+}
+
+void OrderBook::take_quote(std::vector<Level> &levels, uint64_t maker_id, bool maker_is_buy, int64_t maker_price,
+                           int64_t &volume, std::vector<Fill> &fills) {
+  for (auto &level : levels) {
+    if (volume == 0 or not crosses(maker_is_buy, level.price, maker_price)) {
+      break;
+    }
+    auto traded = std::min(volume, level.volume);
+    level.volume -= traded;
+    volume -= traded;
+    if (traded > 0) {
+      fills.push_back({0, maker_id, maker_price, traded});
+    }
+  }
+}
+
+int64_t OrderBook::available(bool buy, int64_t limit, int64_t volume) const {
+  int64_t total = 0;
+  for (const auto &level : buy ? quote_asks_ : quote_bids_) {
+    if (total >= volume or not crosses(buy, level.price, limit)) {
+      break;
+    }
+    total += level.volume;
+  }
+  auto count_level = [&](const auto &pair) {
+    if (total >= volume or not crosses(buy, pair.first, limit)) {
+      return false;
+    }
+    for (const auto &resting : pair.second) {
+      total += resting.volume_left;
+    }
+    return true;
+  };
+  if (buy) {
+    std::find_if_not(asks_.begin(), asks_.end(), count_level);
+  } else {
+    std::find_if_not(bids_.rbegin(), bids_.rend(), count_level);
+  }
+  return total;
+}
+} // namespace kungfu::wingchun::simex
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_SIMEX_MATCHING_ENGINE_H
+#define KUNGFU_SIMEX_MATCHING_ENGINE_H
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <kungfu/longfist/longfist.h>
+#include <kungfu/wingchun/common.h>
+
+namespace kungfu::wingchun::simex {
+/** prices are matched as integer ticks of 1e-6 to avoid floating point comparison */
+constexpr double PRICE_SCALE = 1e6;
+
+inline int64_t to_ticks(double price) { return std::llround(price * PRICE_SCALE); }
+
+inline double from_ticks(int64_t ticks) { return ticks / PRICE_SCALE; }
+
+struct Fill {
+  uint64_t taker_id; // 0 if the taker is quote liquidity
+  uint64_t maker_id; // 0 if the maker is quote liquidity
+  int64_t price;     // ticks
+  int64_t volume;
+};
+
+/**
+ * How an order goes through matching: its limit in ticks, whether the unfilled volume rests in the book, and whether
+ * it fills all or nothing. All-or-none orders never rest, whatever their time condition, since a resting order can be
+ * partially filled by later orders and quotes; they are cancelled if the book can not fill them at once.
+ */
+struct MatchTerms {
+  int64_t limit;
+  bool rest;
+  bool all_or_none;
+
+  explicit MatchTerms(const longfist::types::Order &order);
+
+  /**
+   * @return status of the order after volume_traded of it is filled by OrderBook::match
+   */
+  [[nodiscard]] longfist::enums::OrderStatus get_status(int64_t volume, int64_t volume_traded) const;
+};
+
+/**
+ * Limit order book of one instrument with price-time priority.
+ * Own orders rest in the book by price level, FIFO within a level. When quote liquidity is enabled, levels of the
+ * latest quote sit ahead of own orders at the same price, they are consumed by matching and replaced by the next quote.
+ */
+class OrderBook {
+public:
+  /**
+   * Match an incoming order against the opposite side.
+   * @param limit limit price in ticks, INT64_MAX for market buy and INT64_MIN for market sell
+   * @param rest whether the remaining volume rests in the book
+   * @param all_or_none match nothing unless the whole volume can be filled, nothing rests either way
+   * @return filled volume
+   */
+  int64_t match(uint64_t order_id, longfist::enums::Side side, int64_t limit, int64_t volume, bool rest,
+                bool all_or_none, std::vector<Fill> &fills);
+
+  /**
+   * Remove a resting order.
+   * @return volume left of the removed order, 0 if it is not resting in the book
+   */
+  int64_t cancel(uint64_t order_id, longfist::enums::Side side, int64_t price);
+
+  /**
+   * Replace quote liquidity with levels of the given quote, resting own orders crossed by it are filled at their own
+   * price against the new levels.
+   */
+  void update_quote(const longfist::types::Quote &quote, std::vector<Fill> &fills);
+
+  [[nodiscard]] size_t resting_count() const;
+
+private:
+  struct Resting {
+    uint64_t order_id;
+    int64_t volume_left;
+  };
+
+  struct Level {
+    int64_t price;
+    int64_t volume;
+  };
+
+  typedef std::map<int64_t, std::deque<Resting>> Levels;
+
+  Levels bids_ = {};
+  Levels asks_ = {};
+  std::vector<Level> quote_bids_ = {}; // best first
+  std::vector<Level> quote_asks_ = {}; // best first
+
+  /** whether a maker at price is matchable by a taker of the given side at limit */
+  static bool crosses(bool buy, int64_t price, int64_t limit) { return buy ? price <= limit : price >= limit; }
+
+  static void take_quote(std::vector<Level> &levels, uint64_t maker_id, bool maker_is_buy, int64_t maker_price,
+                         int64_t &volume, std::vector<Fill> &fills);
+
+  int64_t available(bool buy, int64_t limit, int64_t volume) const;
+};
+
+/**
+ * Order books of all instruments, keyed by hash_instrument(exchange_id, instrument_id).
+ */
+class MatchingEngine {
+public:
+  OrderBook &get_book(uint32_t instrument_key) { return books_[instrument_key]; }
+
+  void update_quote(const longfist::types::Quote &quote, std::vector<Fill> &fills) {
+    get_book(hash_instrument(quote.exchange_id, quote.instrument_id)).update_quote(quote, fills);
+  }
+
+private:
+  std::unordered_map<uint32_t, OrderBook> books_ = {};
+};
+} // namespace kungfu::wingchun::simex
+
+#endif // KUNGFU_SIMEX_MATCHING_ENGINE_H
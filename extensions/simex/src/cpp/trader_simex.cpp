@@ -0,0 +1,316 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <kungfu/yijinjing/time.h>
+
+#include "trader_simex.h"
+
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+
+namespace kungfu::wingchun::simex {
+/** resolution of delayed reports and of market data source checks */
+static constexpr int64_t REPORT_INTERVAL = time_unit::NANOSECONDS_PER_MILLISECOND;
+static constexpr int64_t MD_CHECK_INTERVAL = time_unit::NANOSECONDS_PER_SECOND;
+
+struct TDConfiguration {
+  std::string match_mode;
+  std::string md_source;
+  std::string replay_from;
+  int64_t latency_us;
+  int64_t jitter_us;
+};
+
+void from_json(const nlohmann::json &j, TDConfiguration &c) {
+  c.match_mode = j.value("match_mode", "match");
+  c.md_source = j.value("md_source", "");
+  c.replay_from = j.value("replay_from", "");
+  c.latency_us = j.value("latency_us", 0);
+  c.jitter_us = j.value("jitter_us", 0);
+}
+
+static MatchMode parse_match_mode(const std::string &name) {
+  static const std::unordered_map<std::string, MatchMode> modes = {
+      {"reject", MatchMode::Reject},
+      {"pend", MatchMode::Pend},
+      {"cancel", MatchMode::Cancel},
+      {"partialfillandcancel", MatchMode::PartialFillAndCancel},
+      {"partialfill", MatchMode::PartialFill},
+      {"fill", MatchMode::Fill},
+      {"multiple_transactions", MatchMode::Multiple},
+      {"match", MatchMode::Match},
+  };
+  auto it = modes.find(name);
+  if (it == modes.end()) {
+    throw wingchun_error("invalid match mode " + name);
+  }
+  return it->second;
+}
+
+static bool is_active(OrderStatus status) {
+  return status == OrderStatus::Submitted or status == OrderStatus::Pending or
+         status == OrderStatus::PartialFilledActive;
+}
+
+TraderSimex::TraderSimex(broker::BrokerVendor &vendor) : Trader(vendor) { KUNGFU_SETUP_LOG(); }
+
+void TraderSimex::on_start() {
+  TDConfiguration config = nlohmann::json::parse(get_config());
+  match_mode_ = parse_match_mode(config.match_mode);
+  latency_ = std::max<int64_t>(config.latency_us, 0) * time_unit::NANOSECONDS_PER_MICROSECOND;
+  jitter_ = std::max<int64_t>(config.jitter_us, 0) * time_unit::NANOSECONDS_PER_MICROSECOND;
+  random_.seed(get_home_uid());
+  trading_day_ = time::strftime(get_vendor().get_trading_day(), KUNGFU_TRADING_DAY_FORMAT);
+
+  for (auto &pair : orders_) {
+    auto &order = pair.second.data;
+    if (is_active(order.status)) {
+      order.status = OrderStatus::Lost; // resting orders of previous runs are not in the books
+    }
+  }
+
+  if (latency_ > 0 or jitter_ > 0) {
+    add_time_interval(REPORT_INTERVAL, [&](const event_ptr &event) { flush_reports(); });
+  }
+  if (match_mode_ == MatchMode::Match and not config.md_source.empty()) {
+    auto md_location = location::make_shared(mode::LIVE, category::MD, config.md_source, config.md_source,
+                                             get_home()->locator);
+    md_uid_ = md_location->uid;
+    replay_from_ = config.replay_from.empty() ? 0 : time::strptime(config.replay_from, KUNGFU_DATETIME_FORMAT);
+    add_time_interval(MD_CHECK_INTERVAL, [&](const event_ptr &event) { join_market_data(); });
+    SPDLOG_INFO("match against quotes of {}", md_location->uname);
+  }
+  SPDLOG_INFO("simex trader {} started, match mode {}, latency {}us, jitter {}us", get_home()->name,
+              config.match_mode, config.latency_us, config.jitter_us);
+  update_broker_state(BrokerState::Ready);
+}
+
+void TraderSimex::on_trading_day(const event_ptr &event, int64_t daytime) {
+  trading_day_ = time::strftime(daytime, KUNGFU_TRADING_DAY_FORMAT);
+}
+
+bool TraderSimex::insert_order(const event_ptr &event) { return insert_order(event, event->data<OrderInput>()); }
+
+bool TraderSimex::insert_batch_orders(const event_ptr &event) {
+  auto it = order_inputs_.find(event->source());
+  if (it == order_inputs_.end()) {
+    return true;
+  }
+  bool success = true;
+  for (const auto &input : it->second) {
+    success = insert_order(event, input) and success;
+  }
+  return success;
+}
+
+bool TraderSimex::insert_order(const event_ptr &event, const OrderInput &input) {
+  flush_reports();
+  auto nano = time::now_in_nano();
+  Order order = {};
+  order_from_input(input, order);
+  strncpy(order.external_order_id, std::to_string(order.order_id).c_str(), EXTERNAL_ID_LEN);
+  strncpy(order.trading_day, trading_day_.c_str(), DATE_LEN);
+  order.insert_time = nano;
+  order.update_time = nano;
+  auto pair = orders_.insert_or_assign(order.order_id, state<Order>(get_home_uid(), event->source(), nano, order));
+  auto &order_state = pair.first->second;
+
+  auto instrument_type = get_instrument_type(input.exchange_id, input.instrument_id);
+  auto min_volume = instrument_type == InstrumentType::Stock ? 100 : 1;
+  const char *error_msg = nullptr;
+  if (instrument_type == InstrumentType::Repo and input.side == Side::Buy) {
+    error_msg = "repo can not buy";
+  } else if (input.volume < min_volume) {
+    error_msg = "volume too small";
+  } else if (input.block_id != 0 and block_messages_.find(input.block_id) == block_messages_.end()) {
+    error_msg = "No Block Message";
+  } else if (match_mode_ == MatchMode::Reject) {
+    error_msg = "rejected by match mode";
+  }
+  if (error_msg != nullptr) {
+    order_state.data.status = OrderStatus::Error;
+    strncpy(order_state.data.error_msg, error_msg, ERROR_MSG_LEN);
+    report_order(event->gen_time(), order_state);
+    return false;
+  }
+
+  if (match_mode_ == MatchMode::Match) {
+    insert_match(event, order_state);
+  } else {
+    insert_fixed(event, order_state);
+  }
+  return true;
+}
+
+void TraderSimex::insert_fixed(const event_ptr &event, state<Order> &order_state) {
+  auto &order = order_state.data;
+  auto min_volume = get_instrument_type(order.exchange_id, order.instrument_id) == InstrumentType::Stock ? 100 : 1;
+  int64_t volume_traded = 0;
+  switch (match_mode_) {
+  case MatchMode::Pend:
+    order.status = OrderStatus::Pending;
+    break;
+  case MatchMode::Cancel:
+    order.status = OrderStatus::Cancelled;
+    break;
+  case MatchMode::PartialFillAndCancel:
+    volume_traded = min_volume;
+    order.status = volume_traded == order.volume ? OrderStatus::Filled : OrderStatus::PartialFilledNotActive;
+    break;
+  case MatchMode::PartialFill:
+    volume_traded = min_volume;
+    order.status = volume_traded == order.volume ? OrderStatus::Filled : OrderStatus::PartialFilledActive;
+    break;
+  default:
+    volume_traded = order.volume;
+    order.status = OrderStatus::Filled;
+  }
+  order.volume_left = order.volume - volume_traded;
+  report_order(event->gen_time(), order_state);
+  // multiple transactions mode splits the fill into trades of minimum volume
+  auto trade_volume = match_mode_ == MatchMode::Multiple ? min_volume : volume_traded;
+  for (int64_t left = volume_traded; left > 0; left -= trade_volume) {
+    report_trade(event->gen_time(), order_state, std::min(left, trade_volume), order.limit_price);
+  }
+}
+
+void TraderSimex::insert_match(const event_ptr &event, state<Order> &order_state) {
+  auto &order = order_state.data;
+  MatchTerms terms(order);
+
+  fills_.clear();
+  auto &book = engine_.get_book(hash_instrument(order.exchange_id, order.instrument_id));
+  auto volume_traded =
+      book.match(order.order_id, order.side, terms.limit, order.volume, terms.rest, terms.all_or_none, fills_);
+  order.volume_left = order.volume - volume_traded;
+  order.status = terms.get_status(order.volume, volume_traded);
+  report_order(event->gen_time(), order_state);
+  apply_fills(event->gen_time());
+}
+
+bool TraderSimex::cancel_order(const event_ptr &event) {
+  flush_reports();
+  const OrderAction &action = event->data<OrderAction>();
+  auto it = orders_.find(action.order_id);
+  if (it == orders_.end()) {
+    SPDLOG_ERROR("failed to cancel order {}, not found", action.order_id);
+    return false;
+  }
+  auto &order_state = it->second;
+  auto &order = order_state.data;
+  if (not is_active(order.status)) {
+    return true;
+  }
+  if (match_mode_ == MatchMode::Match) {
+    auto &book = engine_.get_book(hash_instrument(order.exchange_id, order.instrument_id));
+    book.cancel(order.order_id, order.side, to_ticks(order.limit_price));
+  }
+  order.status = order.volume_left == order.volume ? OrderStatus::Cancelled : OrderStatus::PartialFilledNotActive;
+  order.update_time = time::now_in_nano();
+  report_order(event->gen_time(), order_state);
+  return true;
+}
+
+void TraderSimex::on_quote(const event_ptr &event) {
+  flush_reports();
+  if (match_mode_ != MatchMode::Match) {
+    return;
+  }
+  fills_.clear();
+  engine_.update_quote(event->data<Quote>(), fills_);
+  apply_fills(event->gen_time());
+}
+
+void TraderSimex::apply_fills(int64_t trigger_time) {
+  for (const auto &fill : fills_) {
+    auto price = from_ticks(fill.price);
+    if (fill.taker_id != 0) {
+      report_trade(trigger_time, orders_.at(fill.taker_id), fill.volume, price);
+    }
+    if (fill.maker_id != 0) {
+      auto &maker_state = orders_.at(fill.maker_id);
+      auto &maker = maker_state.data;
+      maker.volume_left -= fill.volume;
+      maker.status = maker.volume_left == 0 ? OrderStatus::Filled : OrderStatus::PartialFilledActive;
+      maker.update_time = time::now_in_nano();
+      report_order(trigger_time, maker_state);
+      report_trade(trigger_time, maker_state, fill.volume, price);
+    }
+  }
+}
+
+void TraderSimex::report_order(int64_t trigger_time, const state<Order> &order_state) {
+  report(trigger_time, order_state.dest, order_state.data);
+}
+
+void TraderSimex::report_trade(int64_t trigger_time, const state<Order> &order_state, int64_t volume, double price) {
+  const auto &order = order_state.data;
+  Trade trade = {};
+  trade.order_id = order.order_id;
+  trade.external_order_id = order.external_order_id;
+  trade.trading_day = order.trading_day;
+  trade.instrument_id = order.instrument_id;
+  trade.exchange_id = order.exchange_id;
+  trade.instrument_type = order.instrument_type;
+  trade.side = order.side;
+  trade.offset = order.offset;
+  trade.hedge_flag = order.hedge_flag;
+  trade.price = price;
+  trade.volume = volume;
+  report(trigger_time, order_state.dest, trade);
+}
+
+void TraderSimex::report(int64_t trigger_time, uint32_t dest, std::variant<Order, Trade> data) {
+  if (latency_ == 0 and jitter_ == 0) {
+    write({0, trigger_time, dest, std::move(data)});
+    return;
+  }
+  auto jitter = jitter_ > 0 ? static_cast<int64_t>(random_() % jitter_) : 0;
+  auto due_time = time::now_in_nano() + latency_ + jitter;
+  // reports leave in the order they are produced, as on an exchange session
+  if (not reports_.empty()) {
+    due_time = std::max(due_time, reports_.back().due_time);
+  }
+  reports_.push_back({due_time, trigger_time, dest, std::move(data)});
+}
+
+void TraderSimex::write(const Report &report) {
+  if (not has_writer(report.dest)) {
+    SPDLOG_DEBUG("order dest {} is not live, do not write data", get_vendor().get_location_uname(report.dest));
+    return;
+  }
+  auto writer = get_writer(report.dest);
+  if (std::holds_alternative<Order>(report.data)) {
+    writer->write(report.trigger_time, std::get<Order>(report.data));
+    return;
+  }
+  Trade trade = std::get<Trade>(report.data);
+  trade.trade_id = writer->current_frame_uid();
+  trade.external_trade_id = std::to_string(trade.trade_id).c_str();
+  trade.trade_time = time::now_in_nano();
+  writer->write(report.trigger_time, trade);
+}
+
+void TraderSimex::flush_reports() {
+  if (reports_.empty()) {
+    return;
+  }
+  auto nano = time::now_in_nano();
+  while (not reports_.empty() and reports_.front().due_time <= nano) {
+    write(reports_.front());
+    reports_.pop_front();
+  }
+}
+
+void TraderSimex::join_market_data() {
+  auto &vendor = get_vendor();
+  bool live = vendor.is_location_live(md_uid_);
+  if (live and not md_joined_) {
+    vendor.request_read_from_public(now(), md_uid_, replay_from_ > 0 ? replay_from_ : now());
+    SPDLOG_INFO("request quotes from {}", vendor.get_location_uname(md_uid_));
+    replay_from_ = 0; // recorded quotes are replayed once, rejoins after restart of the source read live quotes
+  }
+  md_joined_ = live;
+}
+} // namespace kungfu::wingchun::simex
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_SIMEX_TRADER_H
+#define KUNGFU_SIMEX_TRADER_H
+
+#include <random>
+#include <variant>
+
+#include <kungfu/wingchun/broker/trader.h>
+
+#include "matching_engine.h"
+
+namespace kungfu::wingchun::simex {
+/**
+ * Match modes of the python sim trader, plus Match that runs orders through the matching engine.
+ */
+enum class MatchMode : int8_t {
+  Reject,
+  Pend,
+  Cancel,
+  PartialFillAndCancel,
+  PartialFill,
+  Fill,
+  Multiple,
+  Match,
+};
+
+/**
+ * Simulated trader that matches orders in process.
+ * In Match mode each instrument has an order book with price-time priority, own orders are matched against each
+ * other and, if md_source is configured, against liquidity of quotes read from that market data location, either
+ * live or replayed from replay_from. Orders and trades are reported after latency_us plus a random jitter of up to
+ * jitter_us, in the order they are produced.
+ */
+class TraderSimex : public broker::Trader {
+public:
+  explicit TraderSimex(broker::BrokerVendor &vendor);
+
+  [[nodiscard]] longfist::enums::AccountType get_account_type() const override {
+    return longfist::enums::AccountType::Stock;
+  }
+
+  void on_start() override;
+
+  void on_trading_day(const event_ptr &event, int64_t daytime) override;
+
+  bool insert_order(const event_ptr &event) override;
+
+  bool insert_batch_orders(const event_ptr &event) override;
+
+  bool cancel_order(const event_ptr &event) override;
+
+  bool req_position() override { return false; }
+
+  bool req_account() override { return false; }
+
+  bool req_order_trade() override { return false; }
+
+  void on_quote(const event_ptr &event) override;
+
+private:
+  struct Report {
+    int64_t due_time;
+    int64_t trigger_time;
+    uint32_t dest;
+    std::variant<longfist::types::Order, longfist::types::Trade> data;
+  };
+
+  MatchMode match_mode_ = MatchMode::Match;
+  MatchingEngine engine_ = {};
+  std::vector<Fill> fills_ = {};
+  std::deque<Report> reports_ = {};
+  std::string trading_day_ = {};
+  int64_t latency_ = 0;
+  int64_t jitter_ = 0;
+  std::mt19937_64 random_ = {};
+  uint32_t md_uid_ = 0;
+  bool md_joined_ = false;
+  int64_t replay_from_ = 0;
+
+  bool insert_order(const event_ptr &event, const longfist::types::OrderInput &input);
+
+  void insert_fixed(const event_ptr &event, state<longfist::types::Order> &order_state);
+
+  void insert_match(const event_ptr &event, state<longfist::types::Order> &order_state);
+
+  void apply_fills(int64_t trigger_time);
+
+  void report_order(int64_t trigger_time, const state<longfist::types::Order> &order_state);
+
+  void report_trade(int64_t trigger_time, const state<longfist::types::Order> &order_state, int64_t volume,
+                    double price);
+
+  void report(int64_t trigger_time, uint32_t dest, std::variant<longfist::types::Order, longfist::types::Trade> data);
+
+  void write(const Report &report);
+
+  void flush_reports();
+
+  void join_market_data();
+};
+} // namespace kungfu::wingchun::simex
+
+#endif // KUNGFU_SIMEX_TRADER_H
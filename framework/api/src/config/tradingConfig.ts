@@ -953,6 +953,7 @@ export const ExportTradingDataColumnsToFilter: Record<
   Asset: [],
   OrderInput: [],
   OrderStat: [],
+  LatencyStat: [],
   Quote: [],
   Basket: [],
   BasketInstrument: [],
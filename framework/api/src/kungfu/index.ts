@@ -163,7 +163,27 @@ export const dealTradingDataItem = (
   return itemResolved;
 };
 
-export const getKungfuDataByDateRange = (
+// Pages of the period are read off the event loop and merged into the tables of the first page
+// as they arrive, rows added to a DataTable are indexed lazily on its next query
+export const selectHistoryPeriod = async (
+  from: string,
+  to: string,
+): Promise<KungfuApi.TradingData> => {
+  let page = await history.selectPeriodAsync(from, to);
+  const tradingData = page.data;
+  while (page.cursor) {
+    page = await history.selectPage(page.cursor);
+    const pageData = page.data;
+    (Object.keys(pageData) as KungfuApi.TradingDataTypeName[]).forEach(
+      (key) => {
+        Object.assign(tradingData[key], pageData[key]);
+      },
+    );
+  }
+  return tradingData;
+};
+
+export const getKungfuDataByDateRange = async (
   date: number | string,
   dateType = HistoryDateEnum.naturalDate, //0 natural date, 1 tradingDate
 ): Promise<KungfuApi.TradingData | Record<string, unknown>> => {
@@ -182,45 +202,39 @@ export const getKungfuDataByDateRange = (
     'OrderInput',
   ];
 
-  return new Promise((resolve, reject) => {
-    const timer = setTimeout(() => {
-      //by trading date
-      if (dateType === HistoryDateEnum.tradingDate) {
-        const kungfuDataToday = history.selectPeriod(from, to);
-        const kungfuDataYesterday = history.selectPeriod(yesFrom, from);
-        const kungfuDataFriday = history.selectPeriod(fridayFrom, fridayTo);
-        const historyData: KungfuApi.TradingData | Record<string, unknown> = {};
-
-        if (!kungfuDataToday || !kungfuDataYesterday || !kungfuDataFriday)
-          return reject(new Error('database_locked'));
-
-        dataTypeForHistory.forEach((key) => {
-          if (key === 'Order' || key === 'Trade' || key === 'OrderInput') {
-            historyData[key] = Object.assign(
-              kungfuDataToday[key].filter('trading_day', tradingDay),
-              kungfuDataYesterday[key].filter('trading_day', tradingDay),
-              kungfuDataFriday[key].filter('trading_day', tradingDay),
-            );
-          } else {
-            historyData[key] = Object.assign(
-              kungfuDataFriday[key as keyof KungfuApi.TradingData],
-              kungfuDataYesterday[key as keyof KungfuApi.TradingData],
-              kungfuDataToday[key as keyof KungfuApi.TradingData],
-            );
-          }
-        });
-
-        resolve(historyData);
+  const select = (start: string, end: string) =>
+    selectHistoryPeriod(start, end).catch((err: Error) => {
+      kfLogger.error(err.message);
+      throw new Error('database_locked');
+    });
+
+  //by trading date
+  if (dateType === HistoryDateEnum.tradingDate) {
+    const kungfuDataToday = await select(from, to);
+    const kungfuDataYesterday = await select(yesFrom, from);
+    const kungfuDataFriday = await select(fridayFrom, fridayTo);
+    const historyData: KungfuApi.TradingData | Record<string, unknown> = {};
+
+    dataTypeForHistory.forEach((key) => {
+      if (key === 'Order' || key === 'Trade' || key === 'OrderInput') {
+        historyData[key] = Object.assign(
+          kungfuDataToday[key].filter('trading_day', tradingDay),
+          kungfuDataYesterday[key].filter('trading_day', tradingDay),
+          kungfuDataFriday[key].filter('trading_day', tradingDay),
+        );
       } else {
-        const kungfuDataToday = history.selectPeriod(from, to);
+        historyData[key] = Object.assign(
+          kungfuDataFriday[key as keyof KungfuApi.TradingData],
+          kungfuDataYesterday[key as keyof KungfuApi.TradingData],
+          kungfuDataToday[key as keyof KungfuApi.TradingData],
+        );
+      }
+    });
 
-        if (!kungfuDataToday) return reject(new Error('database_locked'));
+    return historyData;
+  }
 
-        resolve(kungfuDataToday);
-      }
-      clearTimeout(timer);
-    }, 160);
-  });
+  return select(from, to);
 };
 
 export const getKungfuHistoryData = (
@@ -88,6 +88,112 @@ export const startWatcher = () => {
   watcher.start();
 };
 
+const readDeltaValue = (
+  view: DataView,
+  offset: number,
+  dtype: string,
+): number | bigint | boolean | string => {
+  const kind = dtype.charAt(1);
+  const size = +dtype.slice(2);
+  if (kind === 'S') {
+    const bytes = new Uint8Array(view.buffer, view.byteOffset + offset, size);
+    const end = bytes.indexOf(0);
+    return Buffer.from(bytes.subarray(0, end < 0 ? size : end)).toString();
+  }
+  if (kind === 'b') return view.getUint8(offset) !== 0;
+  if (kind === 'f') {
+    return size === 4
+      ? view.getFloat32(offset, true)
+      : view.getFloat64(offset, true);
+  }
+  const signed = kind === 'i';
+  switch (size) {
+    case 1:
+      return signed ? view.getInt8(offset) : view.getUint8(offset);
+    case 2:
+      return signed
+        ? view.getInt16(offset, true)
+        : view.getUint16(offset, true);
+    case 4:
+      return signed
+        ? view.getInt32(offset, true)
+        : view.getUint32(offset, true);
+    default:
+      return signed
+        ? view.getBigInt64(offset, true)
+        : view.getBigUint64(offset, true);
+  }
+};
+
+export const decodeDeltaTable = (
+  schema: KungfuApi.DeltaTableSchema,
+  table: KungfuApi.DeltaTable,
+): Record<string, unknown>[] => {
+  const view = new DataView(table.buffer);
+  const records: Record<string, unknown>[] = [];
+  for (let row = 0; row < table.rows; row++) {
+    const base = row * schema.row_size;
+    const record: Record<string, unknown> = {};
+    schema.fields.forEach((field) => {
+      const itemSize =
+        field.dtype.charAt(1) === 'S' ? 0 : +field.dtype.slice(2);
+      record[field.name] =
+        field.length > 1
+          ? Array.from({ length: field.length }, (_, i) =>
+              readDeltaValue(
+                view,
+                base + field.offset + i * itemSize,
+                field.dtype,
+              ),
+            )
+          : readDeltaValue(view, base + field.offset, field.dtype);
+    });
+    records.push(record);
+  }
+  return records;
+};
+
+const toUidKey = (uid: bigint): string => uid.toString(16).padStart(16, '0');
+
+// Rows of a batch are set to ledger in place, laid out like the ones set natively, so that only the changed records
+// are touched and indexed again
+export const applyDeltaBatch = (
+  watcher: KungfuApi.Watcher,
+  batch: KungfuApi.DeltaBatch,
+) => {
+  const ledger = watcher.ledger as unknown as Record<
+    string,
+    KungfuApi.DataTable<Record<string, unknown>>
+  >;
+  Object.keys(batch.tables).forEach((typeName) => {
+    const schema = watcher.deltaSchema[typeName];
+    const table = ledger[typeName];
+    if (!schema || !table) return;
+    const uidKeys = decodeDeltaTable(schema, batch.tables[typeName]).map(
+      (record) => {
+        const { ts, uid, source, dest, ...data } = record;
+        const uidKey = toUidKey(uid as bigint);
+        if (!(uidKey in table)) {
+          table[uidKey] = Object.defineProperties(
+            {},
+            {
+              tag: { value: schema.tag },
+              type: { value: typeName },
+              uid_key: { value: uidKey },
+              source: { value: source },
+              dest: { value: dest },
+              ts: { value: ts },
+            },
+          );
+        }
+        Object.assign(table[uidKey], data);
+        return uidKey;
+      },
+    );
+    table.reindex(uidKeys);
+  });
+};
+
 export const startWatcherSyncTask = (
   interval = 1000,
   callback?: (watcher: KungfuApi.Watcher) => void,
@@ -95,7 +201,7 @@ export const startWatcherSyncTask = (
   if (watcher === null) return;
   return setTimerPromiseTask(async () => {
     if (watcher.isLive() && watcher.isStarted()) {
-      watcher.sync();
+      applyDeltaBatch(watcher, watcher.syncDelta());
       callback && (await callback(watcher));
     }
     return true;
@@ -25,6 +25,19 @@ export enum StrategyStateStatusEnum {
 
 export type StrategyStateStatusTypes = keyof typeof StrategyStateStatusEnum;
 
+export enum LatencyHopEnum {
+  MdToInput,
+  InputToInsert,
+  InsertToAck,
+  InputToTrade,
+}
+
+export enum BarTypeEnum {
+  Time,
+  Volume,
+  Turnover,
+}
+
 export enum LedgerCategoryEnum {
   td = 0,
   strategy = 1,
@@ -47,6 +47,7 @@ declare namespace KungfuApi {
     CurrencyEnum,
     FundTransEnum,
     FundTransTypeEnum,
+    LatencyHopEnum,
   } from './enums';
   import { Dayjs } from 'dayjs';
   import { Row } from 'fast-csv';
@@ -369,8 +370,33 @@ declare namespace KungfuApi {
     ): KungfuApi.KfConfig | false;
   }
 
+  export interface HistoryCursor {
+    from: bigint;
+    to: bigint;
+    page_size: number;
+    location_index: number;
+    dest_index: number;
+    type_index: number;
+    ts: bigint;
+    skip: number;
+  }
+
+  export interface HistoryPage {
+    data: TradingData;
+    cursor: HistoryCursor | null;
+  }
+
   export interface HistoryStore {
+    /**
+     * @deprecated blocks the event loop while the whole period is read, use selectPeriodAsync and selectPage
+     */
     selectPeriod(from: string, to: string): TradingData | false;
+    selectPeriodAsync(
+      from: string,
+      to?: string,
+      pageSize?: number,
+    ): Promise<HistoryPage>;
+    selectPage(cursor: HistoryCursor): Promise<HistoryPage>;
   }
 
   export interface CommissionStore {
@@ -401,6 +427,20 @@ declare namespace KungfuApi {
     nofilter(key: string, value: string | number | bigint): DataTable<T>;
     sort(key: string): T[];
     list(): T[];
+    query(options?: DataTableQuery): { total: number; rows: T[] };
+    reindex(uidKeys?: string[]): DataTable<T>;
+  }
+
+  export interface DataTableQuery {
+    instrument_id?: string;
+    source?: number;
+    dest?: number;
+    status?: number | number[];
+    from?: bigint;
+    to?: bigint;
+    offset?: number;
+    limit?: number;
+    ascending?: boolean;
   }
 
   export interface Asset {
@@ -652,6 +692,27 @@ declare namespace KungfuApi {
     uid_key: string;
   }
 
+  export interface LatencyStat {
+    strategy_uid: number;
+    account_uid: number;
+    hop: LatencyHopEnum;
+    update_time: bigint;
+    window: bigint;
+    count: bigint;
+    min: bigint;
+    max: bigint;
+    mean: number;
+    p50: bigint;
+    p90: bigint;
+    p99: bigint;
+    p999: bigint;
+    buckets: number[];
+
+    source: number;
+    dest: number;
+    uid_key: string;
+  }
+
   export interface OrderAction {
     order_id: bigint;
     order_action_id: bigint;
@@ -782,6 +843,7 @@ declare namespace KungfuApi {
     Order: DataTable<Order>;
     OrderInput: DataTable<OrderInput>;
     OrderStat: DataTable<OrderStat>;
+    LatencyStat: DataTable<LatencyStat>;
     Position: DataTable<Position>;
     Quote: DataTable<Quote>;
     Trade: DataTable<Trade>;
@@ -823,6 +885,7 @@ declare namespace KungfuApi {
     | Order
     | OrderInput
     | OrderStat
+    | LatencyStat
     | Position
     | Quote
     | Trade;
@@ -910,8 +973,32 @@ declare namespace KungfuApi {
     state: StrategyStateStatusTypes;
   }
 
+  export interface DeltaField {
+    name: string;
+    dtype: string;
+    length: number;
+    offset: number;
+  }
+
+  export interface DeltaTableSchema {
+    tag: number;
+    row_size: number;
+    fields: DeltaField[];
+  }
+
+  export interface DeltaTable {
+    tag: number;
+    rows: number;
+    buffer: ArrayBuffer;
+  }
+
+  export interface DeltaBatch {
+    tables: Record<string, DeltaTable>;
+  }
+
   export interface Watcher {
     appStates: Record<string, BrokerStateStatusEnum>;
+    deltaSchema: Record<string, DeltaTableSchema>;
     strategyStates: Record<string, StrategyStateDataOrigin>;
     ledger: TradingData;
     state: TradingData;
@@ -920,7 +1007,7 @@ declare namespace KungfuApi {
     isStarted(): boolean;
     isUsable(): boolean;
     start(): void;
-    sync(): void;
+    syncDelta(): DeltaBatch;
     isReadyToInteract(kfLocation: KfLocation | KfConfig): boolean;
     requestStop(kfLocation: KfLocation | KfConfig): void;
     getLocationUID(kfLocation: KfLocation | KfConfig): number;
@@ -964,6 +1051,7 @@ declare namespace KungfuApi {
     OrderInput(): OrderInput;
     OrderAction(): OrderAction;
     OrderStat(): OrderStat;
+    LatencyStat(): LatencyStat;
     Position(): Position;
     Quote(): Quote;
     Trade(): Trade;
@@ -1888,6 +1888,7 @@ export const dealTradingDataMethodsMap: Record<
   Order: dealOrderTradingData,
   OrderInput: dealOrderTradingData,
   OrderStat: dealDefaultTradingData,
+  LatencyStat: dealDefaultTradingData,
   Position: dealLedgerTradingData,
   Quote: dealDefaultTradingData,
   Trade: dealOrderTradingData,
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Full market replay through the bar aggregator, five thousand stocks quoted in turn, one quote each 100us:
+//   bar.replay.quote.1spec     one minute bars only
+//   bar.replay.quote.4spec     one and five minute bars, plus volume and turnover bars
+//   bar.replay.transaction     the same four specs, fed by transactions instead of quotes
+// Each operation is one tick; finished bars go to a handler that only counts them, so no journal io is measured.
+// usage: bench_bar [iterations] [baseline.jsonl]
+
+#include "benchmark.h"
+
+#include <kungfu/wingchun/common.h>
+#include <kungfu/wingchun/service/bar.h>
+#include <kungfu/yijinjing/time.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::wingchun::service;
+using namespace kungfu::yijinjing;
+
+static constexpr size_t INSTRUMENT_COUNT = 5000;
+static constexpr int64_t TICK_INTERVAL = 100 * time_unit::NANOSECONDS_PER_MICROSECOND;
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  auto baseline = argc > 2 ? benchmark::load_baseline(argv[2]) : benchmark::baseline{};
+
+  std::vector<Quote> quotes(INSTRUMENT_COUNT);
+  std::vector<Transaction> transactions(INSTRUMENT_COUNT);
+  for (size_t i = 0; i < INSTRUMENT_COUNT; i++) {
+    auto instrument_id = fmt::format("{:06d}", 600000 + i);
+    quotes[i].instrument_id = instrument_id.c_str();
+    quotes[i].exchange_id = EXCHANGE_SSE;
+    quotes[i].trading_day = "20220101";
+    quotes[i].instrument_type = InstrumentType::Stock;
+    transactions[i].instrument_id = instrument_id.c_str();
+    transactions[i].exchange_id = EXCHANGE_SSE;
+    transactions[i].trading_day = "20220101";
+    transactions[i].instrument_type = InstrumentType::Stock;
+  }
+
+  std::vector<BarSpec> one_spec = {{BarType::Time, time_unit::NANOSECONDS_PER_MINUTE, 0, 0}};
+  std::vector<BarSpec> four_specs = {
+      {BarType::Time, time_unit::NANOSECONDS_PER_MINUTE, 0, 0},
+      {BarType::Time, 5 * time_unit::NANOSECONDS_PER_MINUTE, 0, 0},
+      {BarType::Volume, 0, 100000, 0},
+      {BarType::Turnover, 0, 0, 1e6},
+  };
+
+  int64_t bar_count = 0;
+  auto count_bar = [&](int64_t gen_time, const Bar &bar) { bar_count++; };
+
+  auto replay_quotes = [&](const std::string &name, const std::vector<BarSpec> &specs) {
+    BarAggregator aggregator(specs, count_bar);
+    benchmark::throughput(
+        name, iterations,
+        [&](size_t i) {
+          auto &quote = quotes[i % INSTRUMENT_COUNT];
+          auto time = int64_t(i) * TICK_INTERVAL;
+          quote.data_time = time;
+          quote.last_price = 10 + double(i % 100) / 100;
+          quote.volume += 100;
+          quote.turnover += 100 * quote.last_price;
+          aggregator.on_quote(time, quote);
+        },
+        baseline);
+  };
+
+  auto replay_transactions = [&](const std::string &name, const std::vector<BarSpec> &specs) {
+    BarAggregator aggregator(specs, count_bar);
+    benchmark::throughput(
+        name, iterations,
+        [&](size_t i) {
+          auto &transaction = transactions[i % INSTRUMENT_COUNT];
+          auto time = int64_t(i) * TICK_INTERVAL;
+          transaction.data_time = time;
+          transaction.price = 10 + double(i % 100) / 100;
+          transaction.volume = 100;
+          aggregator.on_transaction(time, transaction);
+        },
+        baseline);
+  };
+
+  replay_quotes("bar.replay.quote.1spec", one_spec);
+  replay_quotes("bar.replay.quote.4spec", four_specs);
+  replay_transactions("bar.replay.transaction", four_specs);
+
+  benchmark::keep(bar_count);
+  return 0;
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Cost of the SQLite state cache path that cached runs for every state frame, in a temporary runtime dir:
+//   cache.shift.write.position    replace of one of one hundred existing position rows
+//   cache.shift.write.order       insert of a new order row
+//   cache.shift.restore           restore of all rows written above into a state bank, as done at app start
+// usage: bench_cache [iterations] [baseline.jsonl]
+
+#include "benchmark.h"
+
+#include <kungfu/yijinjing/cache/backend.h>
+#include <kungfu/yijinjing/cache/runtime.h>
+#include <kungfu/yijinjing/io.h>
+#include <kungfu/yijinjing/log.h>
+#include <kungfu/yijinjing/time.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::stoul(argv[1]) : 10000;
+  auto baseline = argc > 2 ? benchmark::load_baseline(argv[2]) : benchmark::baseline{};
+
+  benchmark::runtime runtime("cache");
+  runtime.setup_log();
+  auto locator = runtime.make_locator();
+  ensure_sqlite_initilize();
+
+  auto location = location::make_shared(mode::LIVE, category::TD, "bench", "account", locator);
+  cache::shift shift(location);
+  shift.ensure_storage(location::PUBLIC);
+
+  benchmark::measure(
+      "cache.shift.write.position", iterations,
+      [&](size_t i) {
+        Position position = {};
+        position.instrument_id = fmt::format("{:06d}", 600000 + i % 100).c_str();
+        position.exchange_id = "SSE";
+        position.holder_uid = location->uid;
+        position.direction = Direction::Long;
+        position.volume = i;
+        position.update_time = time::now_in_nano();
+        shift << state<Position>(location->uid, location::PUBLIC, position.update_time, position);
+      },
+      baseline);
+
+  benchmark::measure(
+      "cache.shift.write.order", iterations,
+      [&](size_t i) {
+        Order order = {};
+        order.order_id = i + 1;
+        order.instrument_id = fmt::format("{:06d}", 600000 + i % 100).c_str();
+        order.exchange_id = "SSE";
+        order.volume = 100;
+        order.insert_time = time::now_in_nano();
+        order.update_time = order.insert_time;
+        shift << state<Order>(location->uid, location::PUBLIC, order.insert_time, order);
+      },
+      baseline);
+
+  benchmark::measure(
+      "cache.shift.restore", 10,
+      [&](size_t) {
+        cache::bank bank;
+        shift >> bank;
+        benchmark::keep(bank);
+      },
+      baseline);
+
+  ensure_sqlite_shutdown();
+  return 0;
+}
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Cost of the journal paths every app goes through, on quote frames in a temporary runtime dir:
+//   journal.writer.write              latency of each write of a single writer
+//   journal.reader.next.<n>           read of frames merged from n journals by one reader
+//   journal.assemble.next.<n>         read of the same frames through assemble, as used by replay and trace tools
+//   journal.codec.register.<format>   write and read back of a Register payload, json as before or binary
+// usage: bench_journal [frames] [baseline.jsonl]
+
+#include "benchmark.h"
+
+#include <kungfu/yijinjing/journal/assemble.h>
+#include <kungfu/yijinjing/journal/journal.h>
+#include <kungfu/yijinjing/log.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+using namespace kungfu::yijinjing::journal;
+
+static Quote make_quote(size_t i) {
+  Quote quote = {};
+  quote.instrument_id = fmt::format("{:06d}", 600000 + i % 100).c_str();
+  quote.exchange_id = "SSE";
+  quote.instrument_type = InstrumentType::Stock;
+  quote.last_price = 10 + (i % 100) * 0.01;
+  quote.volume = i;
+  return quote;
+}
+
+/**
+ * Writes frames quotes round robin to the public journals of n md locations under the given locator.
+ */
+static std::vector<location_ptr> write_journals(const locator_ptr &locator, size_t n, size_t frames) {
+  auto publisher = std::make_shared<null_sink>()->get_publisher();
+  std::vector<location_ptr> locations = {};
+  std::vector<writer_ptr> writers = {};
+  for (size_t k = 0; k < n; k++) {
+    locations.push_back(location::make_shared(mode::LIVE, category::MD, "bench", fmt::format("md{}", k), locator));
+    writers.push_back(std::make_shared<writer>(locations.back(), location::PUBLIC, true, publisher));
+  }
+  for (size_t i = 0; i < frames; i++) {
+    writers[i % n]->write(0, make_quote(i));
+  }
+  return locations;
+}
+
+int main(int argc, char **argv) {
+  size_t frames = argc > 1 ? std::stoul(argv[1]) : 200000;
+  auto baseline = argc > 2 ? benchmark::load_baseline(argv[2]) : benchmark::baseline{};
+
+  benchmark::runtime runtime("journal");
+  runtime.setup_log();
+
+  auto write_locator = runtime.make_locator("write");
+  auto write_location = location::make_shared(mode::LIVE, category::MD, "bench", "write", write_locator);
+  writer write_writer(write_location, location::PUBLIC, true, std::make_shared<null_sink>()->get_publisher());
+  std::vector<Quote> quotes = {};
+  for (size_t i = 0; i < 100; i++) {
+    quotes.push_back(make_quote(i));
+  }
+  benchmark::measure(
+      "journal.writer.write", frames, [&](size_t i) { write_writer.write(0, quotes[i % quotes.size()]); }, baseline);
+
+  Register registration = {};
+  registration.location_uid = write_location->uid;
+  registration.category = category::STRATEGY;
+  registration.group = "default";
+  registration.name = "strategy";
+  registration.pid = getpid();
+  benchmark::throughput(
+      "journal.codec.register.json", frames,
+      [&](size_t) { benchmark::keep(Register(registration.to_string()).pid); }, baseline);
+  benchmark::throughput(
+      "journal.codec.register.binary", frames,
+      [&](size_t) { benchmark::keep(Register(registration.to_bytes()).pid); }, baseline);
+
+  for (size_t n : {1, 4, 16, 64}) {
+    auto locator = runtime.make_locator(fmt::format("read-{}", n));
+    auto locations = write_journals(locator, n, frames);
+
+    reader journal_reader(true);
+    for (const auto &location : locations) {
+      journal_reader.join(location, location::PUBLIC, 0);
+    }
+    benchmark::throughput(
+        fmt::format("journal.reader.next.{}", n), frames,
+        [&](size_t) {
+          if (journal_reader.data_available()) {
+            benchmark::keep(journal_reader.current_frame()->gen_time());
+            journal_reader.next();
+          }
+        },
+        baseline);
+
+    assemble journal_assemble({locator});
+    benchmark::throughput(
+        fmt::format("journal.assemble.next.{}", n), frames,
+        [&](size_t) {
+          if (journal_assemble.data_available()) {
+            benchmark::keep(journal_assemble.current_frame()->gen_time());
+            journal_assemble.next();
+          }
+        },
+        baseline);
+  }
+  return 0;
+}
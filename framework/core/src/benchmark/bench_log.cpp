@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Latency of log calls on the calling thread.
+// usage: bench_log [sync|async] [iterations] [queue_size] [block|drop]
+
+#include "benchmark.h"
+
+#include <kungfu/yijinjing/log.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+
+int main(int argc, char **argv) {
+  std::string backend = argc > 1 ? argv[1] : "sync";
+  size_t iterations = argc > 2 ? std::stoul(argv[2]) : 100000;
+  std::string queue_size = argc > 3 ? argv[3] : "65536";
+  std::string overflow = argc > 4 ? argv[4] : "block";
+  if (backend == "async") {
+    setenv(LOG_ASYNC_QUEUE_ENV, queue_size.c_str(), 1);
+    setenv(LOG_OVERFLOW_ENV, overflow.c_str(), 1);
+  }
+
+  benchmark::runtime runtime("log");
+  runtime.setup_log();
+
+  auto name = fmt::format("log.{}", backend == "async" ? fmt::format("async.{}.{}", queue_size, overflow) : backend);
+  benchmark::measure(name, iterations, [](size_t i) { SPDLOG_INFO("benchmark message {} {:.4f}", i, i * 0.5); });
+  spdlog::default_logger()->flush();
+  return 0;
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Read volume of a strategy subscribed to a few instruments of a full market, with and without md shards:
+//   md_shard.read.public           the md writes every quote to its public journal, the strategy reads all of them
+//   md_shard.read.<n>              the md writes each quote to one of n shard bands, the strategy reads only the
+//                                  bands holding its instruments, as Client::connect_bands does
+//   md_shard.volume.<n>            frames read and frames of subscribed instruments in md_shard.read.<n>
+// Each operation is one quote of the market; the reader only sees the frames of the journals it joined.
+// usage: bench_md_shard [frames] [baseline.jsonl]
+
+#include "benchmark.h"
+
+#include <kungfu/wingchun/common.h>
+#include <kungfu/yijinjing/journal/assemble.h>
+#include <kungfu/yijinjing/journal/journal.h>
+#include <kungfu/yijinjing/log.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::wingchun;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+using namespace kungfu::yijinjing::journal;
+
+static constexpr size_t INSTRUMENT_COUNT = 5000;
+static constexpr size_t SUBSCRIBED_COUNT = 10;
+
+int main(int argc, char **argv) {
+  size_t frames = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  auto baseline = argc > 2 ? benchmark::load_baseline(argv[2]) : benchmark::baseline{};
+
+  benchmark::runtime runtime("md-shard");
+  runtime.setup_log();
+
+  std::vector<Quote> quotes(INSTRUMENT_COUNT);
+  for (size_t i = 0; i < INSTRUMENT_COUNT; i++) {
+    quotes[i].instrument_id = fmt::format("{:06d}", 600000 + i).c_str();
+    quotes[i].exchange_id = EXCHANGE_SSE;
+    quotes[i].instrument_type = InstrumentType::Stock;
+  }
+  auto is_subscribed = [&](const Quote &quote) {
+    return hash_instrument(quote.exchange_id, quote.instrument_id) % (INSTRUMENT_COUNT / SUBSCRIBED_COUNT) == 0;
+  };
+
+  auto publisher = std::make_shared<null_sink>()->get_publisher();
+  auto run = [&](const std::string &suffix, uint32_t shard_count) {
+    auto name = fmt::format("md_shard.read.{}", suffix);
+    auto locator = runtime.make_locator(name);
+    auto md_location = location::make_shared(mode::LIVE, category::MD, "bench", "bench", locator);
+
+    std::vector<location_ptr> bands = {};
+    std::vector<writer_ptr> writers = {};
+    if (shard_count == 0) {
+      writers.push_back(std::make_shared<writer>(md_location, location::PUBLIC, true, publisher));
+    }
+    for (uint32_t shard = 0; shard < shard_count; shard++) {
+      auto band_name = get_md_shard_name(shard, shard_count);
+      bands.push_back(location::make_shared(mode::LIVE, category::MD, "bench", band_name, locator));
+      writers.push_back(std::make_shared<writer>(md_location, bands.back()->uid, true, publisher));
+    }
+    for (size_t i = 0; i < frames; i++) {
+      auto &quote = quotes[i % INSTRUMENT_COUNT];
+      quote.last_price = 10 + double(i % 100) / 100;
+      quote.volume += 100;
+      auto shard = shard_count == 0 ? 0 : get_md_shard(quote.exchange_id, quote.instrument_id, shard_count);
+      writers[shard]->write(0, quote);
+    }
+
+    reader md_reader(true);
+    if (shard_count == 0) {
+      md_reader.join(md_location, location::PUBLIC, 0);
+    }
+    for (uint32_t shard = 0; shard < shard_count; shard++) {
+      auto wanted = std::any_of(quotes.begin(), quotes.end(), [&](const Quote &quote) {
+        return is_subscribed(quote) and get_md_shard(quote.exchange_id, quote.instrument_id, shard_count) == shard;
+      });
+      if (wanted) {
+        md_reader.join(md_location, bands[shard]->uid, 0);
+      }
+    }
+
+    size_t frames_read = 0;
+    size_t frames_delivered = 0;
+    benchmark::throughput(
+        name, frames,
+        [&](size_t) {
+          if (md_reader.data_available()) {
+            auto &quote = md_reader.current_frame()->data<Quote>();
+            frames_read++;
+            frames_delivered += is_subscribed(quote);
+            benchmark::keep(quote.last_price);
+            md_reader.next();
+          }
+        },
+        baseline);
+    fmt::print("{{\"name\":\"md_shard.volume.{}\",\"frames_read\":{},\"frames_delivered\":{}}}\n", suffix,
+               frames_read, frames_delivered);
+  };
+
+  run("public", 0);
+  for (uint32_t shard_count : {4, 16, 64}) {
+    run(std::to_string(shard_count), shard_count);
+  }
+  return 0;
+}
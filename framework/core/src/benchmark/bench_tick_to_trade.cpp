@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// End to end tick-to-trade latency of master, cached, ledger, a quote generator md, a loopback td and a strategy,
+// each forked as its own process on a temporary runtime dir. Every hop is measured by the process that ends it:
+//   tick_to_trade.md_to_strategy           quote written by md -> quote callback of strategy
+//   tick_to_trade.strategy_quote_to_order  quote callback -> order input written by strategy
+//   tick_to_trade.strategy_to_td           order input written -> order input read by td
+//   tick_to_trade.td_to_strategy           order written by td -> order callback of strategy
+//   tick_to_trade.round_trip               quote written by md -> order callback of strategy
+// usage: bench_tick_to_trade [seconds] [quotes_per_second] [baseline.jsonl]
+
+#include "benchmark.h"
+
+#include <csignal>
+#include <filesystem>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include <kungfu/wingchun/broker/marketdata.h>
+#include <kungfu/wingchun/broker/trader.h>
+#include <kungfu/wingchun/service/ledger.h>
+#include <kungfu/wingchun/strategy/runner.h>
+#include <kungfu/yijinjing/cache/cached.h>
+#include <kungfu/yijinjing/log.h>
+#include <kungfu/yijinjing/practice/master.h>
+#include <kungfu/yijinjing/time.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::wingchun;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+
+static constexpr const char *SOURCE = "bench";
+static constexpr const char *ACCOUNT = "loopback";
+static constexpr const char *INSTRUMENT_ID = "600000";
+static constexpr const char *EXCHANGE_ID = EXCHANGE_SSE;
+
+class BenchMaster : public practice::master {
+public:
+  explicit BenchMaster(const locator_ptr &locator)
+      : master(location::make_shared(mode::LIVE, category::SYSTEM, "master", "master", locator)) {}
+
+  void on_register(const event_ptr &event, const Register &register_data) override {}
+
+  void on_interval_check(int64_t nanotime) override {}
+
+  int64_t acquire_trading_day() override { return time::today_start(); }
+};
+
+class QuoteGenerator : public broker::MarketData {
+public:
+  QuoteGenerator(broker::BrokerVendor &vendor, int64_t interval) : MarketData(vendor), interval_(interval) {}
+
+  void on_start() override {
+    add_time_interval(interval_, [&](const event_ptr &event) { write_quote(); });
+    update_broker_state(BrokerState::Ready);
+  }
+
+  bool subscribe(const std::vector<InstrumentKey> &instrument_keys) override { return true; }
+
+  bool unsubscribe(const std::vector<InstrumentKey> &instrument_keys) override { return true; }
+
+private:
+  const int64_t interval_;
+  int64_t count_ = 0;
+
+  void write_quote() {
+    auto writer = get_writer(location::PUBLIC);
+    Quote &quote = writer->open_data<Quote>(0);
+    quote.instrument_id = INSTRUMENT_ID;
+    quote.exchange_id = EXCHANGE_ID;
+    quote.instrument_type = InstrumentType::Stock;
+    quote.last_price = 10 + (count_++ % 10) * 0.01;
+    quote.bid_price[0] = quote.last_price - 0.01;
+    quote.ask_price[0] = quote.last_price + 0.01;
+    quote.bid_volume[0] = 10000;
+    quote.ask_volume[0] = 10000;
+    quote.data_time = time::now_in_nano();
+    writer->close_data();
+  }
+};
+
+class LoopbackTrader : public broker::Trader {
+public:
+  LoopbackTrader(broker::BrokerVendor &vendor, const benchmark::baseline &base) : Trader(vendor), baseline_(base) {}
+
+  [[nodiscard]] AccountType get_account_type() const override { return AccountType::Stock; }
+
+  void on_start() override { update_broker_state(BrokerState::Ready); }
+
+  void on_exit() override { benchmark::report("tick_to_trade.strategy_to_td", strategy_to_td_, baseline_); }
+
+  bool insert_order(const event_ptr &event) override {
+    strategy_to_td_.push_back(time::now_in_nano() - event->gen_time());
+    const OrderInput &input = event->data<OrderInput>();
+    auto writer = get_writer(event->source());
+
+    Order order = {};
+    order_from_input(input, order);
+    order.insert_time = event->gen_time();
+    order.status = OrderStatus::Filled;
+    order.volume_left = 0;
+
+    Trade trade = {};
+    trade_from_order(order, trade);
+    trade.trade_id = writer->current_frame_uid();
+    trade.price = input.limit_price;
+    trade.volume = input.volume;
+    trade.trade_time = time::now_in_nano();
+
+    order.update_time = time::now_in_nano();
+    writer->write(event->gen_time(), order);
+    writer->write(event->gen_time(), trade);
+    return true;
+  }
+
+  bool cancel_order(const event_ptr &event) override { return false; }
+
+  bool req_position() override { return false; }
+
+  bool req_account() override { return false; }
+
+  bool req_order_trade() override { return false; }
+
+private:
+  const benchmark::baseline &baseline_;
+  std::vector<int64_t> strategy_to_td_ = {};
+};
+
+class TickToTradeStrategy : public strategy::Strategy {
+public:
+  explicit TickToTradeStrategy(const benchmark::baseline &base) : baseline_(base) {}
+
+  void pre_start(strategy::Context_ptr &context) override {
+    context->bypass_accounting();
+    context->add_account(SOURCE, ACCOUNT);
+    context->subscribe(SOURCE, {INSTRUMENT_ID}, EXCHANGE_ID);
+  }
+
+  void post_stop(strategy::Context_ptr &context) override {
+    benchmark::report("tick_to_trade.md_to_strategy", md_to_strategy_, baseline_);
+    benchmark::report("tick_to_trade.strategy_quote_to_order", quote_to_order_, baseline_);
+    benchmark::report("tick_to_trade.td_to_strategy", td_to_strategy_, baseline_);
+    benchmark::report("tick_to_trade.round_trip", round_trip_, baseline_);
+  }
+
+  void on_quote(strategy::Context_ptr &context, const Quote &quote, const location_ptr &location) override {
+    auto read_time = time::now_in_nano();
+    md_to_strategy_.push_back(read_time - quote.data_time);
+    auto order_id = context->insert_order(INSTRUMENT_ID, EXCHANGE_ID, SOURCE, ACCOUNT, quote.ask_price[0], 100,
+                                          PriceType::Limit, Side::Buy, Offset::Open);
+    if (order_id != 0) {
+      quote_to_order_.push_back(time::now_in_nano() - read_time);
+      quote_times_.emplace(order_id, quote.data_time);
+    }
+  }
+
+  void on_order(strategy::Context_ptr &context, const Order &order, const location_ptr &location) override {
+    auto read_time = time::now_in_nano();
+    td_to_strategy_.push_back(read_time - order.update_time);
+    auto quote_time = quote_times_.find(order.order_id);
+    if (quote_time != quote_times_.end()) {
+      round_trip_.push_back(read_time - quote_time->second);
+      quote_times_.erase(quote_time);
+    }
+  }
+
+private:
+  const benchmark::baseline &baseline_;
+  std::unordered_map<uint64_t, int64_t> quote_times_ = {};
+  std::vector<int64_t> md_to_strategy_ = {};
+  std::vector<int64_t> quote_to_order_ = {};
+  std::vector<int64_t> td_to_strategy_ = {};
+  std::vector<int64_t> round_trip_ = {};
+};
+
+/**
+ * Runs the given app in a child process, logs of the child go to file only to keep stdout for results.
+ */
+template <typename Run> pid_t spawn(const benchmark::runtime &runtime, const std::string &name, Run &&run) {
+  auto pid = fork();
+  if (pid == 0) {
+    runtime.setup_log(name);
+    run();
+    fflush(stdout);
+    _exit(0);
+  }
+  return pid;
+}
+
+int main(int argc, char **argv) {
+  int64_t seconds = argc > 1 ? std::stoll(argv[1]) : 10;
+  int64_t rate = argc > 2 ? std::stoll(argv[2]) : 1000;
+  auto baseline = argc > 3 ? benchmark::load_baseline(argv[3]) : benchmark::baseline{};
+
+  benchmark::runtime runtime("tick-to-trade");
+  std::filesystem::create_directories(runtime.get_root());
+  setenv("KF_RUNTIME_DIR", runtime.get_root().c_str(), 1);
+  auto locator = runtime.make_locator();
+  auto settle = std::chrono::seconds(2);
+
+  // services come first, md and td have to be live before the strategy adds them
+  std::vector<pid_t> pids = {};
+  pids.push_back(spawn(runtime, "master", [&]() { BenchMaster(locator).run(); }));
+  std::this_thread::sleep_for(settle);
+  pids.push_back(spawn(runtime, "cached", [&]() { cache::cached(locator, mode::LIVE).run(); }));
+  pids.push_back(spawn(runtime, "ledger", [&]() { service::Ledger(locator, mode::LIVE).run(); }));
+  std::this_thread::sleep_for(settle);
+  pids.push_back(spawn(runtime, "md", [&]() {
+    broker::MarketDataVendor vendor(locator, SOURCE, SOURCE, true);
+    vendor.set_service(std::make_shared<QuoteGenerator>(vendor, time_unit::NANOSECONDS_PER_SECOND / rate));
+    vendor.run();
+  }));
+  pids.push_back(spawn(runtime, "td", [&]() {
+    broker::TraderVendor vendor(locator, SOURCE, ACCOUNT, true);
+    vendor.set_service(std::make_shared<LoopbackTrader>(vendor, baseline));
+    vendor.run();
+  }));
+  std::this_thread::sleep_for(settle);
+  pids.push_back(spawn(runtime, "strategy", [&]() {
+    strategy::Runner runner(locator, "default", "tick_to_trade", mode::LIVE, true);
+    runner.add_strategy(std::make_shared<TickToTradeStrategy>(baseline));
+    runner.run();
+  }));
+
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+  // stop in reverse order so that the strategy and td report before the services they depend on are gone
+  for (auto pid = pids.rbegin(); pid != pids.rend(); pid++) {
+    kill(*pid, SIGTERM);
+    waitpid(*pid, nullptr, 0);
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Cost and accuracy of time::now_in_nano for each clock source.
+// usage: bench_time [iterations] [accuracy_seconds]
+
+#include "benchmark.h"
+
+#include <thread>
+#include <kungfu/yijinjing/time.h>
+
+using namespace kungfu;
+using namespace kungfu::yijinjing;
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  int64_t accuracy_seconds = argc > 2 ? std::stoll(argv[2]) : 5;
+
+  time::set_clock_source(clock_source::steady);
+  benchmark::throughput("time.now_in_nano.steady", iterations, [](size_t) { benchmark::keep(time::now_in_nano()); });
+
+  if (not time::set_clock_source(clock_source::tsc)) {
+    fmt::print(R"({{"name":"time.now_in_nano.tsc","error":"invariant tsc not supported"}})"
+               "\n");
+    return 0;
+  }
+  benchmark::throughput("time.now_in_nano.tsc", iterations, [](size_t) { benchmark::keep(time::now_in_nano()); });
+
+  // error of tsc reading against steady reading, sampled every millisecond across several resync intervals
+  std::vector<int64_t> errors = {};
+  auto end = time::now_in_nano() + accuracy_seconds * time_unit::NANOSECONDS_PER_SECOND;
+  while (time::now_in_nano() < end) {
+    time::set_clock_source(clock_source::steady);
+    auto before = time::now_in_nano();
+    time::set_clock_source(clock_source::tsc);
+    auto tsc = time::now_in_nano();
+    time::set_clock_source(clock_source::steady);
+    auto after = time::now_in_nano();
+    errors.push_back(std::abs(tsc - before / 2 - after / 2));
+    time::set_clock_source(clock_source::tsc);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  benchmark::report("time.now_in_nano.tsc.abs_error", errors);
+  return 0;
+}
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Throughput of time::strptime and time::strftime on the formats kungfu emits.
+// usage: bench_time_parse [iterations]
+
+#include "benchmark.h"
+
+#include <kungfu/yijinjing/time.h>
+
+using namespace kungfu;
+using namespace kungfu::yijinjing;
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  auto base = time::now_in_nano();
+  std::vector<std::string> formats = {KUNGFU_TIMESTAMP_FORMAT, KUNGFU_DATETIME_FORMAT, KUNGFU_TRADING_DAY_FORMAT,
+                                      KUNGFU_HISTORY_DAY_FORMAT};
+  for (const auto &format : formats) {
+    std::vector<std::string> samples = {};
+    for (size_t i = 0; i < 1024; i++) {
+      samples.push_back(time::strftime(base + i * 123456789, format));
+    }
+    benchmark::throughput(fmt::format("time.strptime.{}", format), iterations,
+                          [&](size_t i) { benchmark::keep(time::strptime(samples[i & 1023u], format)); });
+    benchmark::throughput(fmt::format("time.strftime.{}", format), iterations,
+                          [&](size_t i) { benchmark::keep(time::strftime(base + i * 123456789, format)); });
+  }
+  return 0;
+}
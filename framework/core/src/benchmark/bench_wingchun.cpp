@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Cost of the wingchun accounting paths, on a book of one hundred stock positions:
+//   wingchun.hash_instrument                 hash of exchange id and instrument id, the key of every book lookup
+//   wingchun.bookkeeper.update_book.quote    mark to market of all books holding the quoted instrument
+//   wingchun.bookkeeper.update_book.trade    stock accounting of a buy or sell trade, then the book update
+// The bookkeeper is the one of a ledger that is constructed but never run, so nothing else touches it.
+// usage: bench_wingchun [iterations] [baseline.jsonl]
+
+#include "benchmark.h"
+
+#include <kungfu/wingchun/book/accounting.h>
+#include <kungfu/wingchun/common.h>
+#include <kungfu/wingchun/service/ledger.h>
+#include <kungfu/yijinjing/log.h>
+
+using namespace kungfu;
+using namespace kungfu::longfist::enums;
+using namespace kungfu::longfist::types;
+using namespace kungfu::wingchun;
+using namespace kungfu::yijinjing;
+using namespace kungfu::yijinjing::data;
+
+static constexpr size_t INSTRUMENT_COUNT = 100;
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  auto baseline = argc > 2 ? benchmark::load_baseline(argv[2]) : benchmark::baseline{};
+
+  benchmark::runtime runtime("wingchun");
+  runtime.setup_log();
+  auto locator = runtime.make_locator();
+
+  std::vector<std::string> instrument_ids = {};
+  for (size_t i = 0; i < INSTRUMENT_COUNT; i++) {
+    instrument_ids.push_back(fmt::format("{:06d}", 600000 + i));
+  }
+
+  benchmark::throughput(
+      "wingchun.hash_instrument", iterations,
+      [&](size_t i) { benchmark::keep(hash_instrument(EXCHANGE_SSE, instrument_ids[i % INSTRUMENT_COUNT].c_str())); },
+      baseline);
+
+  service::Ledger ledger(locator, mode::LIVE);
+  auto &bookkeeper = ledger.get_bookkeeper();
+  auto book_uid = ledger.get_home_uid();
+
+  std::vector<Trade> trades = {};
+  std::vector<Quote> quotes = {};
+  for (size_t i = 0; i < INSTRUMENT_COUNT * 2; i++) {
+    Trade trade = {};
+    trade.instrument_id = instrument_ids[i % INSTRUMENT_COUNT].c_str();
+    trade.exchange_id = EXCHANGE_SSE;
+    trade.instrument_type = InstrumentType::Stock;
+    trade.side = i < INSTRUMENT_COUNT ? Side::Buy : Side::Sell;
+    trade.offset = i < INSTRUMENT_COUNT ? Offset::Open : Offset::Close;
+    trade.price = 10;
+    trade.volume = 100;
+    trades.push_back(trade);
+  }
+  for (size_t i = 0; i < INSTRUMENT_COUNT; i++) {
+    Quote quote = {};
+    quote.instrument_id = instrument_ids[i].c_str();
+    quote.exchange_id = EXCHANGE_SSE;
+    quote.instrument_type = InstrumentType::Stock;
+    quote.last_price = 10.01;
+    quotes.push_back(quote);
+  }
+
+  // buys of all instruments, then sells of all instruments, so that positions stay bounded
+  auto apply_trade = &book::AccountingMethod::apply_trade;
+  auto update_by_trade = [&](size_t i) {
+    auto &trade = trades[i % trades.size()];
+    bookkeeper.update_book<Trade>(i, book_uid, location::PUBLIC, trade, apply_trade);
+  };
+  for (size_t i = 0; i < INSTRUMENT_COUNT; i++) {
+    update_by_trade(i);
+  }
+  benchmark::throughput(
+      "wingchun.bookkeeper.update_book.quote", iterations,
+      [&](size_t i) { bookkeeper.update_book(i, quotes[i % INSTRUMENT_COUNT]); }, baseline);
+  benchmark::throughput(
+      "wingchun.bookkeeper.update_book.trade", iterations,
+      [&](size_t i) { update_by_trade(i + INSTRUMENT_COUNT); }, baseline);
+  return 0;
+}
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_BENCHMARK_H
+#define KUNGFU_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include <kungfu/yijinjing/log.h>
+
+namespace kungfu::benchmark {
+typedef std::unordered_map<std::string, nlohmann::json> baseline;
+
+/**
+ * Loads results of a previous run, the JSON lines printed by report, keyed by name.
+ * Benchmarks take such a file, saved from stdout of an earlier run, as their last optional argument, then each result
+ * is printed with its relative change against the one of the same name in it.
+ */
+inline baseline load_baseline(const std::string &path) {
+  baseline results = {};
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    auto result = nlohmann::json::parse(line, nullptr, false);
+    if (result.is_object() and result.contains("name")) {
+      results.insert_or_assign(result["name"].get<std::string>(), result);
+    }
+  }
+  return results;
+}
+
+/**
+ * Prints one JSON line with latency percentiles of the given samples in nano seconds.
+ * If the baseline has a result of the same name, each percentile also gets its relative change against it.
+ */
+inline void report(const std::string &name, std::vector<int64_t> &samples, const baseline &base = {}) {
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&](double p) { return samples.at(std::min(samples.size() - 1, size_t(samples.size() * p))); };
+  auto mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  std::vector<std::pair<std::string, double>> stats = {
+      {"mean_ns", mean},
+      {"p50_ns", percentile(0.5)},
+      {"p90_ns", percentile(0.9)},
+      {"p99_ns", percentile(0.99)},
+      {"p999_ns", percentile(0.999)},
+      {"p9999_ns", percentile(0.9999)},
+      {"max_ns", samples.back()},
+  };
+  auto line = fmt::format(R"({{"name":"{}","iterations":{})", name, samples.size());
+  for (const auto &stat : stats) {
+    line += fmt::format(R"(,"{}":{:.0f})", stat.first, stat.second);
+  }
+  auto previous = base.find(name);
+  for (const auto &stat : stats) {
+    auto before = previous == base.end() ? 0.0 : previous->second.value(stat.first, 0.0);
+    if (before > 0) {
+      line += fmt::format(R"(,"{}_change":{:.3f})", stat.first, stat.second / before - 1);
+    }
+  }
+  fmt::print("{}}}\n", line);
+}
+
+/**
+ * Times every single call of body(i), suitable for operations that are much slower than a clock read.
+ */
+template <typename Body>
+void measure(const std::string &name, size_t iterations, Body &&body, const baseline &base = {}) {
+  std::vector<int64_t> samples(iterations);
+  for (size_t i = 0; i < iterations; i++) {
+    auto start = std::chrono::steady_clock::now();
+    body(i);
+    samples[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+  report(name, samples, base);
+}
+
+/**
+ * Times iterations calls of body(i) as a whole, prints one JSON line with mean cost and rate.
+ * If the baseline has a result of the same name, the mean cost also gets its relative change against it.
+ */
+template <typename Body>
+void throughput(const std::string &name, size_t iterations, Body &&body, const baseline &base = {}) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    body(i);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  auto ns_per_op = double(elapsed.count()) / std::max<size_t>(iterations, 1);
+  auto line = fmt::format(R"({{"name":"{}","iterations":{},"ns_per_op":{:.2f},"ops_per_sec":{:.0f})", name,
+                          iterations, ns_per_op, ns_per_op > 0 ? 1e9 / ns_per_op : 0);
+  auto previous = base.find(name);
+  auto before = previous == base.end() ? 0.0 : previous->second.value("ns_per_op", 0.0);
+  if (before > 0) {
+    line += fmt::format(R"(,"ns_per_op_change":{:.3f})", ns_per_op / before - 1);
+  }
+  fmt::print("{}}}\n", line);
+}
+
+/**
+ * Temporary runtime dir of one benchmark run, named kungfu-bench-{name}-{pid} under the system temp dir, removed when
+ * it goes out of scope.
+ */
+class runtime {
+public:
+  explicit runtime(const std::string &name)
+      : root_(std::filesystem::temp_directory_path() / fmt::format("kungfu-bench-{}-{}", name, getpid())) {}
+
+  ~runtime() { std::filesystem::remove_all(root_); }
+
+  [[nodiscard]] const std::filesystem::path &get_root() const { return root_; }
+
+  /**
+   * @param dir sub dir of the runtime dir, empty for the runtime dir itself
+   */
+  [[nodiscard]] yijinjing::data::locator_ptr make_locator(const std::string &dir = "") const {
+    return std::make_shared<yijinjing::data::locator>((dir.empty() ? root_ : root_ / dir).string());
+  }
+
+  /**
+   * Sends logs of the calling process to a node location of the given name in the runtime dir.
+   */
+  void setup_log(const std::string &name = "bench") const {
+    using namespace yijinjing::data;
+    auto location = location::make_shared(longfist::enums::mode::LIVE, longfist::enums::category::SYSTEM, "node", name,
+                                          make_locator());
+    yijinjing::log::setup_log(location, name);
+  }
+
+private:
+  const std::filesystem::path root_;
+};
+
+/**
+ * Keeps the compiler from optimizing away a computed value.
+ */
+template <typename T> inline void keep(const T &value) { asm volatile("" : : "g"(&value) : "memory"); }
+} // namespace kungfu::benchmark
+
+#endif // KUNGFU_BENCHMARK_H
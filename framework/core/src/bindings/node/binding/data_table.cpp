@@ -7,6 +7,8 @@
 #include "data_table.h"
 #include "common.h"
 
+#include <optional>
+
 using namespace kungfu::yijinjing;
 
 namespace kungfu::node {
@@ -23,12 +25,14 @@ Napi::Value DataTable::Filter(const Napi::CallbackInfo &info) {
   }
   auto key = info[0].ToString().Utf8Value();
   auto result = constructor.New({info.This()});
+  auto result_table = Unwrap(result);
   auto names = Value().GetPropertyNames();
   for (int i = 0; i < names.Length(); i++) {
     auto name = names.Get(i);
     auto data = Value().Get(name).ToObject();
     if (data.Get(key) == info[1]) {
       result.Set(name, data);
+      result_table->Adopt(Value(), name.ToString().Utf8Value(), data);
     }
   }
   return result;
@@ -43,12 +47,14 @@ Napi::Value DataTable::NoFilter(const Napi::CallbackInfo &info) {
   }
   auto key = info[0].ToString().Utf8Value();
   auto result = constructor.New({info.This()});
+  auto result_table = Unwrap(result);
   auto names = Value().GetPropertyNames();
   for (int i = 0; i < names.Length(); i++) {
     auto name = names.Get(i);
     auto data = Value().Get(name).ToObject();
     if (data.Get(key) != info[1]) {
       result.Set(name, data);
+      result_table->Adopt(Value(), name.ToString().Utf8Value(), data);
     }
   }
   return result;
@@ -70,11 +76,14 @@ Napi::Value DataTable::Merge(const Napi::CallbackInfo &info) {
     }
   }
   auto result = constructor.New({info.This()});
-  auto add_all = [&](auto &&target) {
+  auto result_table = Unwrap(result);
+  auto add_all = [&](const Napi::Object &target) {
     auto names = target.GetPropertyNames();
     for (int i = 0; i < names.Length(); i++) {
       auto name = names.Get(i);
-      result.Set(name, target.Get(name).ToObject());
+      auto data = target.Get(name).ToObject();
+      result.Set(name, data);
+      result_table->Adopt(target, name.ToString().Utf8Value(), data);
     }
   };
   add_all(Value().ToObject());
@@ -95,6 +104,7 @@ Napi::Value DataTable::Range(const Napi::CallbackInfo &info) {
   }
   auto key = info[0].ToString().Utf8Value();
   auto result = constructor.New({info.This()});
+  auto result_table = Unwrap(result);
   auto names = Value().GetPropertyNames();
   for (int i = 0; i < names.Length(); i++) {
     auto name = names.Get(i);
@@ -103,6 +113,7 @@ Napi::Value DataTable::Range(const Napi::CallbackInfo &info) {
     auto add = [&](const auto &val, const auto &lower_bound, const auto &upper_bound) {
       if (val >= lower_bound and (val <= upper_bound or upper_bound == lower_bound)) {
         result.Set(name, data);
+        result_table->Adopt(Value(), name.ToString().Utf8Value(), data);
       }
     };
     if (value.IsNumber() and IsValid(info, 1, &Napi::Value::IsNumber)) {
@@ -170,6 +181,242 @@ Napi::Value DataTable::Sort(const Napi::CallbackInfo &info) {
   return result;
 }
 
+Napi::Value DataTable::Query(const Napi::CallbackInfo &info) {
+  Reconcile(false);
+  auto options = IsValid(info, 0, &Napi::Value::IsObject) ? info[0].ToObject() : Napi::Object::New(info.Env());
+  auto has = [&](const char *name) {
+    return options.Has(name) and not options.Get(name).IsUndefined() and not options.Get(name).IsNull();
+  };
+  std::optional<std::string> instrument_id = {};
+  std::optional<uint32_t> source = {};
+  std::optional<uint32_t> dest = {};
+  std::unordered_set<int32_t> statuses = {};
+  if (has("instrument_id")) {
+    instrument_id = options.Get("instrument_id").ToString().Utf8Value();
+  }
+  if (has("source")) {
+    source = options.Get("source").ToNumber().Uint32Value();
+  }
+  if (has("dest")) {
+    dest = options.Get("dest").ToNumber().Uint32Value();
+  }
+  if (has("status") and options.Get("status").IsArray()) {
+    auto array = options.Get("status").As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      statuses.insert(array.Get(i).ToNumber().Int32Value());
+    }
+  } else if (has("status")) {
+    statuses.insert(options.Get("status").ToNumber().Int32Value());
+  }
+  int64_t from = has("from") ? GetBigInt(options.Get("from")) : INT64_MIN;
+  int64_t to = has("to") ? GetBigInt(options.Get("to")) : INT64_MAX;
+  size_t offset = has("offset") ? options.Get("offset").ToNumber().Uint32Value() : 0;
+  size_t limit = has("limit") ? options.Get("limit").ToNumber().Uint32Value() : SIZE_MAX - offset;
+  bool ascending = has("ascending") and options.Get("ascending").ToBoolean().Value();
+
+  // start from the smallest matching equality index, fall back to walking the time index
+  const std::unordered_set<std::string> *candidates = nullptr;
+  bool no_match = false;
+  auto narrow = [&](const auto &index, const auto &value) {
+    auto iter = index.find(value);
+    if (iter == index.end()) {
+      no_match = true;
+    } else if (candidates == nullptr or iter->second.size() < candidates->size()) {
+      candidates = &iter->second;
+    }
+  };
+  if (instrument_id) {
+    narrow(by_instrument_, *instrument_id);
+  }
+  if (source) {
+    narrow(by_source_, *source);
+  }
+  if (dest) {
+    narrow(by_dest_, *dest);
+  }
+  if (statuses.size() == 1) {
+    narrow(by_status_, *statuses.begin());
+  }
+
+  auto match = [&](const DataTableRow &row) {
+    return (not instrument_id or row.instrument_id == *instrument_id) and (not source or row.source == *source) and
+           (not dest or row.dest == *dest) and (statuses.empty() or statuses.count(row.status) > 0) and
+           row.update_time >= from and row.update_time <= to;
+  };
+
+  // rows deleted from JS are still indexed until seen here, they are skipped and dropped after the walk
+  auto table = Value();
+  std::vector<std::string> stale = {};
+  auto present = [&](const std::string &uid_key) {
+    if (table.Has(uid_key)) {
+      return true;
+    }
+    stale.push_back(uid_key);
+    return false;
+  };
+
+  size_t total = 0;
+  std::vector<const std::string *> window = {};
+  if (no_match) {
+    // nothing to collect
+  } else if (candidates == nullptr) {
+    auto collect = [&](const std::string &uid_key) {
+      if (match(rows_.at(uid_key)) and present(uid_key)) {
+        if (total >= offset and window.size() < limit) {
+          window.push_back(&uid_key);
+        }
+        total++;
+      }
+    };
+    auto begin = by_update_time_.lower_bound({from, {}});
+    auto end = to == INT64_MAX ? by_update_time_.end() : by_update_time_.lower_bound({to + 1, {}});
+    if (ascending) {
+      std::for_each(begin, end, [&](const auto &pair) { collect(pair.second); });
+    } else {
+      std::for_each(std::make_reverse_iterator(end), std::make_reverse_iterator(begin),
+                    [&](const auto &pair) { collect(pair.second); });
+    }
+  } else {
+    std::vector<std::pair<int64_t, const std::string *>> matched = {};
+    for (const auto &uid_key : *candidates) {
+      const auto &row = rows_.at(uid_key);
+      if (match(row) and present(uid_key)) {
+        matched.emplace_back(row.update_time, &uid_key);
+      }
+    }
+    total = matched.size();
+    auto order = [&](const auto &a, const auto &b) {
+      auto less = a.first != b.first ? a.first < b.first : *a.second < *b.second;
+      auto greater = a.first != b.first ? a.first > b.first : *a.second > *b.second;
+      return ascending ? less : greater;
+    };
+    if (offset < total) {
+      auto window_end = matched.begin() + std::min(total, offset + limit);
+      std::partial_sort(matched.begin(), window_end, matched.end(), order);
+      std::for_each(matched.begin() + offset, window_end, [&](const auto &pair) { window.push_back(pair.second); });
+    }
+  }
+
+  auto rows = Napi::Array::New(info.Env(), window.size());
+  for (uint32_t i = 0; i < window.size(); i++) {
+    rows.Set(i, table.Get(*window[i]));
+  }
+  for (const auto &uid_key : stale) {
+    Unindex(uid_key);
+  }
+  auto result = Napi::Object::New(info.Env());
+  result.Set("total", Napi::Number::New(info.Env(), total));
+  result.Set("rows", rows);
+  return result;
+}
+
+Napi::Value DataTable::Reindex(const Napi::CallbackInfo &info) {
+  if (not IsValid(info, 0, &Napi::Value::IsArray)) {
+    Reconcile(true);
+    return info.This();
+  }
+  auto table = Value();
+  auto uid_keys = info[0].As<Napi::Array>();
+  for (uint32_t i = 0; i < uid_keys.Length(); i++) {
+    auto uid_key = uid_keys.Get(i).ToString().Utf8Value();
+    auto object = table.Get(uid_key);
+    if (object.IsObject()) {
+      IndexObject(uid_key, object.ToObject());
+    } else {
+      Unindex(uid_key);
+    }
+  }
+  return info.This();
+}
+
+void DataTable::Index(const std::string &uid_key, const DataTableRow &row) {
+  Unindex(uid_key);
+  by_instrument_[row.instrument_id].insert(uid_key);
+  by_source_[row.source].insert(uid_key);
+  by_dest_[row.dest].insert(uid_key);
+  by_status_[row.status].insert(uid_key);
+  by_update_time_.emplace(row.update_time, uid_key);
+  rows_.emplace(uid_key, row);
+}
+
+void DataTable::Unindex(const std::string &uid_key) {
+  auto iter = rows_.find(uid_key);
+  if (iter == rows_.end()) {
+    return;
+  }
+  auto erase = [&](auto &index, const auto &value) {
+    auto index_iter = index.find(value);
+    if (index_iter != index.end()) {
+      index_iter->second.erase(uid_key);
+      if (index_iter->second.empty()) {
+        index.erase(index_iter);
+      }
+    }
+  };
+  const auto &row = iter->second;
+  erase(by_instrument_, row.instrument_id);
+  erase(by_source_, row.source);
+  erase(by_dest_, row.dest);
+  erase(by_status_, row.status);
+  by_update_time_.erase({row.update_time, uid_key});
+  rows_.erase(iter);
+}
+
+void DataTable::IndexObject(const std::string &uid_key, const Napi::Object &object) {
+  auto has = [&](const char *name) { return object.Has(name) and not object.Get(name).IsUndefined(); };
+  DataTableRow row = {};
+  row.instrument_id = has("instrument_id") ? object.Get("instrument_id").ToString().Utf8Value() : "";
+  row.source = has("source") ? object.Get("source").ToNumber().Uint32Value() : 0;
+  row.dest = has("dest") ? object.Get("dest").ToNumber().Uint32Value() : 0;
+  row.status = has("status") ? object.Get("status").ToNumber().Int32Value() : 0;
+  row.update_time = has("update_time") ? GetBigInt(object.Get("update_time"))
+                    : has("ts")        ? GetBigInt(object.Get("ts"))
+                                       : 0;
+  Index(uid_key, row);
+}
+
+void DataTable::Adopt(const Napi::Object &source, const std::string &uid_key, const Napi::Object &object) {
+  auto source_table = Find(source);
+  auto iter = source_table == nullptr ? rows_.end() : source_table->rows_.find(uid_key);
+  if (source_table != nullptr and iter != source_table->rows_.end()) {
+    Index(uid_key, iter->second);
+  } else {
+    IndexObject(uid_key, object);
+  }
+}
+
+void DataTable::Reconcile(bool force) {
+  auto table = Value();
+  auto names = table.GetPropertyNames();
+  if (not force and names.Length() == rows_.size()) {
+    return;
+  }
+  std::unordered_set<std::string> seen = {};
+  for (uint32_t i = 0; i < names.Length(); i++) {
+    auto uid_key = names.Get(i).ToString().Utf8Value();
+    if (force or rows_.find(uid_key) == rows_.end()) {
+      auto object = table.Get(uid_key);
+      if (object.IsObject()) {
+        IndexObject(uid_key, object.ToObject());
+      }
+    }
+    seen.insert(uid_key);
+  }
+  std::vector<std::string> gone = {};
+  for (const auto &pair : rows_) {
+    if (seen.find(pair.first) == seen.end()) {
+      gone.push_back(pair.first);
+    }
+  }
+  for (const auto &uid_key : gone) {
+    Unindex(uid_key);
+  }
+}
+
+DataTable *DataTable::Find(const Napi::Object &table) {
+  return table.InstanceOf(constructor.Value()) ? Unwrap(table) : nullptr;
+}
+
 void DataTable::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
 
@@ -180,7 +427,9 @@ void DataTable::Init(Napi::Env env, Napi::Object exports) {
                                         InstanceMethod("list", &DataTable::List),         //
                                         InstanceMethod("merge", &DataTable::Merge),       //
                                         InstanceMethod("range", &DataTable::Range),       //
-                                        InstanceMethod("sort", &DataTable::Sort)          //
+                                        InstanceMethod("sort", &DataTable::Sort),         //
+                                        InstanceMethod("query", &DataTable::Query),       //
+                                        InstanceMethod("reindex", &DataTable::Reindex)    //
                                     });
 
   constructor = Napi::Persistent(func);
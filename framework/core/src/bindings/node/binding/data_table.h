@@ -9,7 +9,55 @@
 
 #include "common.h"
 
+#include <kungfu/common.h>
+#include <set>
+
 namespace kungfu::node {
+/**
+ * Natively indexed columns of a row, the time column is update_time if the type has one, else its timestamp key, else
+ * the time the row was set.
+ */
+struct DataTableRow {
+  std::string instrument_id;
+  uint32_t source;
+  uint32_t dest;
+  int32_t status;
+  int64_t update_time;
+};
+
+template <typename DataType>
+DataTableRow MakeDataTableRow(const DataType &data, uint32_t source, uint32_t dest, int64_t ts) {
+  DataTableRow row = {{}, source, dest, 0, ts};
+  bool has_update_time = false;
+  boost::hana::for_each(boost::hana::accessors<DataType>(), [&](auto it) {
+    auto name = boost::hana::first(it).c_str();
+    auto accessor = boost::hana::second(it);
+    using ValueType = std::decay_t<decltype(accessor(data))>;
+    if constexpr (is_array_of_v<ValueType, char>) {
+      if (strcmp(name, "instrument_id") == 0) {
+        row.instrument_id = std::string(accessor(data).value, strnlen(accessor(data).value, ValueType::length));
+      }
+    }
+    if constexpr (std::is_enum_v<ValueType>) {
+      if (strcmp(name, "status") == 0) {
+        row.status = static_cast<int32_t>(accessor(data));
+      }
+    }
+    if constexpr (std::is_integral_v<ValueType> and sizeof(ValueType) == sizeof(int64_t)) {
+      if (strcmp(name, "update_time") == 0) {
+        row.update_time = accessor(data);
+        has_update_time = true;
+      }
+      if constexpr (DataType::has_timestamp) {
+        if (not has_update_time and strcmp(name, DataType::timestamp_key.value().c_str()) == 0) {
+          row.update_time = accessor(data);
+        }
+      }
+    }
+  });
+  return row;
+}
+
 class DataTable : public Napi::ObjectWrap<DataTable> {
 public:
   explicit DataTable(const Napi::CallbackInfo &info);
@@ -28,12 +76,47 @@ public:
 
   Napi::Value Sort(const Napi::CallbackInfo &info);
 
+  Napi::Value Query(const Napi::CallbackInfo &info);
+
+  /**
+   * Rebuilds the whole index, or only the rows of the given uid keys, for rows changed in place from JS.
+   */
+  Napi::Value Reindex(const Napi::CallbackInfo &info);
+
+  void Index(const std::string &uid_key, const DataTableRow &row);
+
+  void Unindex(const std::string &uid_key);
+
+  static DataTable *Find(const Napi::Object &table);
+
   static void Init(Napi::Env env, Napi::Object exports);
 
   static Napi::Value NewInstance(Napi::Value arg);
 
 private:
   static Napi::FunctionReference constructor;
+  std::unordered_map<std::string, DataTableRow> rows_ = {};
+  std::unordered_map<std::string, std::unordered_set<std::string>> by_instrument_ = {};
+  std::unordered_map<uint32_t, std::unordered_set<std::string>> by_source_ = {};
+  std::unordered_map<uint32_t, std::unordered_set<std::string>> by_dest_ = {};
+  std::unordered_map<int32_t, std::unordered_set<std::string>> by_status_ = {};
+  std::set<std::pair<int64_t, std::string>> by_update_time_ = {};
+
+  /**
+   * Indexes a row set by JS, from the own properties of its object: instrument_id, source, dest, status, and
+   * update_time if present, else ts.
+   */
+  void IndexObject(const std::string &uid_key, const Napi::Object &object);
+
+  /**
+   * Indexes a row of a table derived from source, reusing its index entry if it has one.
+   */
+  void Adopt(const Napi::Object &source, const std::string &uid_key, const Napi::Object &object);
+
+  /**
+   * Catches up with rows added or deleted from JS, which bypass the index, if the number of rows differs.
+   */
+  void Reconcile(bool force);
 };
 } // namespace kungfu::node
 #endif // KUNGFU_NODE_DATA_TABLE_H
@@ -19,6 +19,132 @@ using namespace kungfu::yijinjing;
 using namespace kungfu::yijinjing::data;
 
 namespace kungfu::node {
+HistoryCursor HistoryCursor::FromObject(const Napi::Object &object) {
+  HistoryCursor cursor = {};
+  cursor.from = GetBigInt(object.Get("from"));
+  cursor.to = GetBigInt(object.Get("to"));
+  cursor.page_size = object.Get("page_size").ToNumber().Uint32Value();
+  cursor.location_index = object.Get("location_index").ToNumber().Uint32Value();
+  cursor.dest_index = object.Get("dest_index").ToNumber().Uint32Value();
+  cursor.type_index = object.Get("type_index").ToNumber().Uint32Value();
+  cursor.ts = GetBigInt(object.Get("ts"));
+  cursor.skip = object.Get("skip").ToNumber().Uint32Value();
+  cursor.done = false;
+  return cursor;
+}
+
+Napi::Object HistoryCursor::ToObject(Napi::Env env) const {
+  auto object = Napi::Object::New(env);
+  object.Set("from", Napi::BigInt::New(env, from));
+  object.Set("to", Napi::BigInt::New(env, to));
+  object.Set("page_size", Napi::Number::New(env, page_size));
+  object.Set("location_index", Napi::Number::New(env, location_index));
+  object.Set("dest_index", Napi::Number::New(env, dest_index));
+  object.Set("type_index", Napi::Number::New(env, type_index));
+  object.Set("ts", Napi::BigInt::New(env, ts));
+  object.Set("skip", Napi::Number::New(env, skip));
+  return object;
+}
+
+HistoryPageWorker::HistoryPageWorker(Napi::Env env, locator_ptr locator, location_ptr ledger_location,
+                                     const HistoryCursor &cursor)
+    : AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)), locator_(std::move(locator)),
+      ledger_location_(std::move(ledger_location)), cursor_(cursor) {}
+
+Napi::Promise HistoryPageWorker::GetPromise() const { return deferred_.Promise(); }
+
+void HistoryPageWorker::Execute() {
+  try {
+    std::vector<location_ptr> locations = {};
+    for (const auto &config : practice::profile(locator_).get_all(Config{})) {
+      locations.push_back(location::make_shared(config, locator_));
+    }
+    locations.push_back(ledger_location_);
+
+    uint32_t remaining = cursor_.page_size;
+    while (remaining > 0 and cursor_.location_index < locations.size()) {
+      const auto &location = locations.at(cursor_.location_index);
+      auto dests = locator_->list_location_dest_by_db(location);
+      std::sort(dests.begin(), dests.end());
+      if (cursor_.dest_index >= dests.size()) {
+        cursor_.location_index++;
+        cursor_.dest_index = 0;
+        continue;
+      }
+      auto dest = dests.at(cursor_.dest_index);
+      auto db_file = locator_->layout_file(location, layout::SQLITE, fmt::format("{:08x}", dest));
+      auto storage = make_storage_ptr(db_file, StateDataTypes);
+
+      uint32_t type_index = 0;
+      boost::hana::for_each(StateDataTypes, [&](auto it) {
+        using DataType = typename decltype(+boost::hana::second(it))::type;
+        if (type_index++ != cursor_.type_index or remaining == 0) {
+          return;
+        }
+        remaining -= ReadPage<DataType>(storage, location->uid, dest, remaining);
+        if (remaining > 0) {
+          cursor_.type_index++;
+          cursor_.ts = cursor_.from;
+          cursor_.skip = 0;
+        }
+      });
+      if (cursor_.type_index >= type_index) {
+        cursor_.dest_index++;
+        cursor_.type_index = 0;
+      }
+    }
+    cursor_.done = cursor_.location_index >= locations.size();
+  } catch (const std::exception &ex) {
+    SetError(fmt::format("failed to select page: {}", ex.what()));
+  }
+}
+
+void HistoryPageWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+  Napi::ObjectReference data_ref = Napi::ObjectReference::New(Napi::Object::New(Env()));
+  serialize::InitStateMap(data_ref, "history");
+  serialize::JsUpdateState update(data_ref);
+  boost::hana::for_each(StateDataTypes, [&](auto it) {
+    for (const auto &pair : bank_[+boost::hana::second(it)]) {
+      const auto &s = pair.second;
+      update(s.update_time, s.source, s.dest, s.data);
+    }
+  });
+  auto result = Napi::Object::New(Env());
+  result.Set("data", data_ref.Value());
+  if (cursor_.done) {
+    result.Set("cursor", Env().Null());
+  } else {
+    result.Set("cursor", cursor_.ToObject(Env()));
+  }
+  deferred_.Resolve(result);
+}
+
+void HistoryPageWorker::OnError(const Napi::Error &error) { deferred_.Reject(error.Value()); }
+
+template <typename DataType>
+uint32_t HistoryPageWorker::ReadPage(StateStoragePtr &storage, uint32_t source, uint32_t dest, uint32_t limit) {
+  using spec = time_spec<DataType>;
+  auto now = time::now_in_nano();
+  auto rows = spec::get_page(storage, cursor_.ts, cursor_.to, cursor_.skip, limit);
+  for (const auto &data : rows) {
+    bank_ << state<DataType>(source, dest, now, data);
+  }
+  if constexpr (DataType::has_timestamp) {
+    // keyset on timestamp, only rows sharing the last timestamp are skipped by offset
+    if (not rows.empty()) {
+      auto last = spec::get_time(rows.back());
+      auto is_last = [&](const DataType &data) { return spec::get_time(data) == last; };
+      auto same = std::count_if(rows.begin(), rows.end(), is_last);
+      cursor_.skip = last == cursor_.ts ? cursor_.skip + same : same;
+      cursor_.ts = last;
+    }
+  } else {
+    cursor_.skip += rows.size();
+  }
+  return rows.size();
+}
+
 Napi::FunctionReference History::constructor = {};
 
 History::History(const Napi::CallbackInfo &info)
@@ -47,10 +173,40 @@ Napi::Value History::SelectPeriod(const Napi::CallbackInfo &info) {
   }
 }
 
+Napi::Value History::SelectPeriodAsync(const Napi::CallbackInfo &info) {
+  auto parse_time = [&](auto i) { return time::strptime(info[i].ToString().Utf8Value(), KUNGFU_HISTORY_DAY_FORMAT); };
+  HistoryCursor cursor = {};
+  cursor.from = parse_time(0);
+  cursor.to = IsValid(info, 1, &Napi::Value::IsString) ? parse_time(1) : cursor.from + time_unit::NANOSECONDS_PER_DAY;
+  cursor.page_size = IsValid(info, 2, &Napi::Value::IsNumber) ? info[2].ToNumber().Uint32Value() : 0;
+  cursor.page_size = cursor.page_size > 0 ? cursor.page_size : HISTORY_DEFAULT_PAGE_SIZE;
+  cursor.ts = cursor.from;
+  SPDLOG_INFO("select period from {} to {} by page of {}", time::strftime(cursor.from), time::strftime(cursor.to),
+              cursor.page_size);
+  auto worker = new HistoryPageWorker(info.Env(), locator_, ledger_location_, cursor);
+  worker->Queue();
+  return worker->GetPromise();
+}
+
+Napi::Value History::SelectPage(const Napi::CallbackInfo &info) {
+  if (not IsValid(info, 0, &Napi::Value::IsObject)) {
+    throw Napi::Error::New(info.Env(), "Invalid history cursor");
+  }
+  auto cursor = HistoryCursor::FromObject(info[0].ToObject());
+  auto worker = new HistoryPageWorker(info.Env(), locator_, ledger_location_, cursor);
+  worker->Queue();
+  return worker->GetPromise();
+}
+
 void History::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
 
-  Napi::Function func = DefineClass(env, "History", {InstanceMethod("selectPeriod", &History::SelectPeriod)});
+  Napi::Function func = DefineClass(env, "History",
+                                    {
+                                        InstanceMethod("selectPeriod", &History::SelectPeriod),           //
+                                        InstanceMethod("selectPeriodAsync", &History::SelectPeriodAsync), //
+                                        InstanceMethod("selectPage", &History::SelectPage),               //
+                                    });
 
   constructor = Napi::Persistent(func);
   constructor.SuppressDestruct();
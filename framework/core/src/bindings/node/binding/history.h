@@ -9,10 +9,61 @@
 
 #include "common.h"
 
+#include <kungfu/yijinjing/cache/backend.h>
 #include <kungfu/yijinjing/common.h>
 #include <kungfu/yijinjing/practice/profile.h>
 
 namespace kungfu::node {
+constexpr uint32_t HISTORY_DEFAULT_PAGE_SIZE = 1000;
+
+/**
+ * Position of a paged history query: which state database (location, dest) and which type to read next, plus the
+ * timestamp and the number of rows at that timestamp already delivered.
+ */
+struct HistoryCursor {
+  int64_t from;
+  int64_t to;
+  uint32_t page_size;
+  uint32_t location_index;
+  uint32_t dest_index;
+  uint32_t type_index;
+  int64_t ts;
+  uint32_t skip;
+  bool done;
+
+  static HistoryCursor FromObject(const Napi::Object &object);
+
+  [[nodiscard]] Napi::Object ToObject(Napi::Env env) const;
+};
+
+/**
+ * Reads one page of history off the main thread, resolves to {data, cursor}, where cursor is null once exhausted.
+ */
+class HistoryPageWorker : public Napi::AsyncWorker {
+public:
+  HistoryPageWorker(Napi::Env env, yijinjing::data::locator_ptr locator, yijinjing::data::location_ptr ledger_location,
+                    const HistoryCursor &cursor);
+
+  [[nodiscard]] Napi::Promise GetPromise() const;
+
+protected:
+  void Execute() override;
+
+  void OnOK() override;
+
+  void OnError(const Napi::Error &error) override;
+
+private:
+  Napi::Promise::Deferred deferred_;
+  yijinjing::data::locator_ptr locator_;
+  yijinjing::data::location_ptr ledger_location_;
+  HistoryCursor cursor_;
+  yijinjing::cache::bank bank_ = {};
+
+  template <typename DataType>
+  uint32_t ReadPage(yijinjing::cache::StateStoragePtr &storage, uint32_t source, uint32_t dest, uint32_t limit);
+};
+
 class History : public Napi::ObjectWrap<History> {
 public:
   explicit History(const Napi::CallbackInfo &info);
@@ -23,6 +74,10 @@ public:
 
   Napi::Value SelectPeriod(const Napi::CallbackInfo &info);
 
+  Napi::Value SelectPeriodAsync(const Napi::CallbackInfo &info);
+
+  Napi::Value SelectPage(const Napi::CallbackInfo &info);
+
   static Napi::Value NewInstance(Napi::Value arg);
 
 private:
@@ -37,7 +37,12 @@ void JsPublishState::operator()(Napi::Object object) {
       object.Set("source", Napi::Number::New(state_.Env(), location->uid));
       object.Set("dest", Napi::Number::New(state_.Env(), 0));
       object.Set("ts", Napi::BigInt::New(state_.Env(), now));
-      state_.Get(type_name).ToObject().Set(uid_key, object);
+      auto table = state_.Get(type_name).ToObject();
+      table.Set(uid_key, object);
+      auto data_table = DataTable::Find(table);
+      if (data_table != nullptr) {
+        data_table->Index(uid_key, MakeDataTableRow(data, location->uid, 0, now));
+      }
       app_.write_to(0, data);
     }
   });
@@ -37,8 +37,12 @@ void JsResetCache::operator()(const state<CacheReset> &state) {
           delete_keys.push_back(name);
         }
       }
+      auto data_table = DataTable::Find(table);
       for (const auto &key : delete_keys) {
         table.Delete(key);
+        if (data_table != nullptr) {
+          data_table->Unindex(key);
+        }
       }
     }
   });
@@ -31,4 +31,42 @@ void InitTradingDataInStateMap(Napi::ObjectReference &state, const std::string &
   state.Value().DefineProperty(Napi::PropertyDescriptor::Value("state_name", Napi::String::New(state.Env(), name)));
 }
 
+Napi::Object MakeDeltaSchema(Napi::Env env) {
+  auto schema = Napi::Object::New(env);
+  boost::hana::for_each(longfist::StateDataTypes, [&](auto it) {
+    using DataType = typename decltype(+boost::hana::second(it))::type;
+    if constexpr (size_fixed_v<DataType>) {
+      auto fields = Napi::Array::New(env);
+      auto add_field = [&](const std::string &name, const std::pair<std::string, size_t> &dtype, size_t offset) {
+        auto field = Napi::Object::New(env);
+        field.Set("name", Napi::String::New(env, name));
+        field.Set("dtype", Napi::String::New(env, dtype.first));
+        field.Set("length", Napi::Number::New(env, dtype.second));
+        field.Set("offset", Napi::Number::New(env, offset));
+        fields.Set(fields.Length(), field);
+      };
+      constexpr size_t source_offset = sizeof(int64_t) + sizeof(uint64_t);
+      add_field("ts", {yijinjing::journal::numpy_dtype<int64_t>(), 1}, 0);
+      add_field("uid", {yijinjing::journal::numpy_dtype<uint64_t>(), 1}, sizeof(int64_t));
+      add_field("source", {yijinjing::journal::numpy_dtype<uint32_t>(), 1}, source_offset);
+      add_field("dest", {yijinjing::journal::numpy_dtype<uint32_t>(), 1}, source_offset + sizeof(uint32_t));
+      DataType sample = {};
+      auto base = reinterpret_cast<uintptr_t>(&sample);
+      boost::hana::for_each(boost::hana::accessors<DataType>(), [&](auto it) {
+        auto accessor = boost::hana::second(it);
+        using AttrType = std::decay_t<decltype(accessor(sample))>;
+        auto offset = reinterpret_cast<uintptr_t>(&accessor(sample)) - base;
+        add_field(boost::hana::first(it).c_str(), yijinjing::journal::numpy_field_dtype<AttrType>(),
+                  JsDeltaBatch::ROW_HEADER_SIZE + offset);
+      });
+      auto type_schema = Napi::Object::New(env);
+      type_schema.Set("tag", Napi::Number::New(env, DataType::tag));
+      type_schema.Set("row_size", Napi::Number::New(env, JsDeltaBatch::ROW_HEADER_SIZE + sizeof(DataType)));
+      type_schema.Set("fields", fields);
+      schema.Set(DataType::type_name.c_str(), type_schema);
+    }
+  });
+  return schema;
+}
+
 } // namespace kungfu::node::serialize
\ No newline at end of file
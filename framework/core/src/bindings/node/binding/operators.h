@@ -13,6 +13,7 @@
 #include <kungfu/common.h>
 #include <kungfu/longfist/longfist.h>
 #include <kungfu/yijinjing/cache/backend.h>
+#include <kungfu/yijinjing/journal/columnar.h>
 #include <kungfu/yijinjing/practice/apprentice.h>
 #include <kungfu/yijinjing/time.h>
 
@@ -127,6 +128,10 @@ public:
     object.Set("source", Napi::Number::New(table.Env(), source));
     object.Set("dest", Napi::Number::New(table.Env(), dest));
     object.Set("ts", Napi::BigInt::New(table.Env(), ts));
+    auto data_table = DataTable::Find(table);
+    if (data_table != nullptr) {
+      data_table->Index(uid_key, MakeDataTableRow(data, source, dest, ts));
+    }
   }
 
 private:
@@ -356,6 +361,48 @@ private:
   JsSet set = {};
 };
 
+/**
+ * Packs changed states of size fixed types into one ArrayBuffer per type, rows are laid out as
+ * [ts:i64][uid:u64][source:u32][dest:u32][data], uid is data.uid() that keys the row in ledger, the layout of data is
+ * described by MakeDeltaSchema.
+ */
+class JsDeltaBatch {
+public:
+  static constexpr size_t ROW_HEADER_SIZE = sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint32_t) * 2;
+
+  explicit JsDeltaBatch(Napi::Env env) : batch_(Napi::Object::New(env)) {}
+
+  template <typename DataType> void operator()(std::unordered_map<uint64_t, state<DataType>> &states) {
+    if (states.empty()) {
+      return;
+    }
+    constexpr size_t row_size = ROW_HEADER_SIZE + sizeof(DataType);
+    auto buffer = Napi::ArrayBuffer::New(batch_.Env(), states.size() * row_size);
+    auto cursor = static_cast<uint8_t *>(buffer.Data());
+    for (const auto &pair : states) {
+      const auto &s = pair.second;
+      uint64_t uid = s.data.uid();
+      memcpy(cursor, &s.update_time, sizeof(int64_t));
+      memcpy(cursor + sizeof(int64_t), &uid, sizeof(uint64_t));
+      memcpy(cursor + sizeof(int64_t) + sizeof(uint64_t), &s.source, sizeof(uint32_t));
+      memcpy(cursor + sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint32_t), &s.dest, sizeof(uint32_t));
+      memcpy(cursor + ROW_HEADER_SIZE, &s.data, sizeof(DataType));
+      cursor += row_size;
+    }
+    auto table = Napi::Object::New(batch_.Env());
+    table.Set("tag", Napi::Number::New(batch_.Env(), DataType::tag));
+    table.Set("rows", Napi::Number::New(batch_.Env(), states.size()));
+    table.Set("buffer", buffer);
+    batch_.Set(DataType::type_name.c_str(), table);
+    states.clear();
+  }
+
+  [[nodiscard]] Napi::Object Value() const { return batch_; }
+
+private:
+  Napi::Object batch_;
+};
+
 class JsPublishState {
 public:
   JsPublishState(yijinjing::practice::apprentice &app, Napi::ObjectReference &state);
@@ -382,6 +429,11 @@ private:
 void InitStateMap(Napi::ObjectReference &state, const std::string &name);
 
 void InitTradingDataInStateMap(Napi::ObjectReference &state, const std::string &name);
+
+/**
+ * Row layout of every size fixed state type shipped by JsDeltaBatch, field dtypes follow numpy notation.
+ */
+Napi::Object MakeDeltaSchema(Napi::Env env);
 } // namespace kungfu::node::serialize
 
 #endif // KUNGFU_NODE_SERIALIZE_H
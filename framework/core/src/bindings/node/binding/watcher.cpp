@@ -139,6 +139,7 @@ Watcher::Watcher(const Napi::CallbackInfo &info)
       app_states_ref_(Napi::ObjectReference::New(Napi::Object::New(info.Env()), 1)),              //
       config_ref_(Napi::ObjectReference::New(ConfigStore::NewInstance({info[0]}).ToObject(), 1)), //
       strategy_states_ref_(Napi::ObjectReference::New(Napi::Object::New(info.Env()), 1)),         //
+      delta_schema_ref_(Napi::ObjectReference::New(serialize::MakeDeltaSchema(info.Env()), 1)),   //
       update_state(state_ref_),                                                                   //
       update_ledger(ledger_ref_),                                                                 //
       publish(*this, state_ref_),                                                                 //
@@ -250,6 +251,8 @@ Napi::Value Watcher::GetAppStates(const Napi::CallbackInfo &info) { return app_s
 
 Napi::Value Watcher::GetStrategyStates(const Napi::CallbackInfo &info) { return strategy_states_ref_.Value(); }
 
+Napi::Value Watcher::GetDeltaSchema(const Napi::CallbackInfo &info) { return delta_schema_ref_.Value(); }
+
 Napi::Value Watcher::GetTradingDay(const Napi::CallbackInfo &info) {
   return Napi::String::New(ledger_ref_.Env(), time::strftime(get_trading_day(), KUNGFU_TRADING_DAY_FORMAT));
 }
@@ -407,13 +410,14 @@ void Watcher::Init(Napi::Env env, Napi::Object exports) {
                       InstanceMethod("requestMarketData", &Watcher::RequestMarketData),                 //
                       InstanceMethod("requestPosition", &Watcher::RequestPosition),                     //
                       InstanceMethod("start", &Watcher::Start),                                         //
-                      InstanceMethod("sync", &Watcher::Sync),                                           //
+                      InstanceMethod("syncDelta", &Watcher::SyncDelta),                                 //
                       InstanceMethod("quit", &Watcher::Quit),                                           //
                       InstanceAccessor("state", &Watcher::GetState, &Watcher::NoSet),                   //
                       InstanceAccessor("ledger", &Watcher::GetLedger, &Watcher::NoSet),                 //
                       InstanceAccessor("appStates", &Watcher::GetAppStates, &Watcher::NoSet),           //
                       InstanceAccessor("strategyStates", &Watcher::GetStrategyStates, &Watcher::NoSet), //
                       InstanceAccessor("tradingDay", &Watcher::GetTradingDay, &Watcher::NoSet),         //
+                      InstanceAccessor("deltaSchema", &Watcher::GetDeltaSchema, &Watcher::NoSet),       //
                   });
 
   constructor = Napi::Persistent(func);
@@ -515,23 +519,19 @@ Napi::Value Watcher::Start(const Napi::CallbackInfo &info) {
   return {};
 }
 
-void Watcher::Sync(const Napi::CallbackInfo &info) {
+Napi::Value Watcher::SyncDelta(const Napi::CallbackInfo &info) {
   std::lock_guard<std::mutex> guard(feed_mutex_);
   SyncEventCache();
   SyncAppStates();
   SyncStrategyStates();
-  SyncLedger();
   TryRefreshTradingData();
-  SyncTradingData();
-}
-
-void Watcher::SyncLedger() {
-  boost::hana::for_each(StateDataTypes, [&](auto it) {
-    if (boost::hana::contains(longfist::TradingDataTypes, boost::hana::first(it))) {
-      return;
-    }
-    UpdateLedger(+boost::hana::second(it));
-  });
+  // data_bank_ holds only states changed since last sync, keyed by uid, size fixed ones go to JS as raw rows, the few
+  // size unfixed ones are set to ledger in place
+  serialize::JsDeltaBatch batch(info.Env());
+  boost::hana::for_each(StateDataTypes, [&](auto it) { UpdateDelta(+boost::hana::second(it), batch); });
+  auto result = Napi::Object::New(info.Env());
+  result.Set("tables", batch.Value());
+  return result;
 }
 
 void Watcher::TryRefreshTradingData() {
@@ -540,10 +540,6 @@ void Watcher::TryRefreshTradingData() {
   }
 }
 
-void Watcher::SyncTradingData() {
-  boost::hana::for_each(TradingDataTypes, [&](auto it) { UpdateTradingData(+boost::hana::second(it)); });
-}
-
 void Watcher::SyncAppStates() {
   for (auto &s : location_uid_states_map_) {
     auto app_state = Napi::Number::New(app_states_ref_.Env(), s.second);
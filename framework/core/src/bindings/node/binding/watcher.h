@@ -23,7 +23,6 @@
 namespace kungfu::node {
 constexpr uint64_t ID_TRANC = 0x00000000FFFFFFFF;
 constexpr uint32_t PAGE_ID_MASK = 0x80000000;
-constexpr uint32_t TRANSFER_TRADING_DATA_LIMIT = 2000;
 
 class WatcherAutoClient : public wingchun::broker::SilentAutoClient {
 public:
@@ -67,6 +66,8 @@ public:
 
   Napi::Value GetStrategyStates(const Napi::CallbackInfo &info);
 
+  Napi::Value GetDeltaSchema(const Napi::CallbackInfo &info);
+
   Napi::Value GetTradingDay(const Napi::CallbackInfo &info);
 
   Napi::Value Now(const Napi::CallbackInfo &info);
@@ -99,7 +100,7 @@ public:
 
   Napi::Value Start(const Napi::CallbackInfo &info);
 
-  void Sync(const Napi::CallbackInfo &info);
+  Napi::Value SyncDelta(const Napi::CallbackInfo &info);
 
   static void Init(Napi::Env env, Napi::Object exports);
 
@@ -130,6 +131,7 @@ private:
   Napi::ObjectReference app_states_ref_;
   Napi::ObjectReference config_ref_;
   Napi::ObjectReference strategy_states_ref_;
+  Napi::ObjectReference delta_schema_ref_;
   serialize::JsUpdateState update_state;
   serialize::JsUpdateState update_ledger;
   serialize::JsPublishState publish;
@@ -198,12 +200,8 @@ private:
 
   void UpdateBook(const event_ptr &event, const longfist::types::Position &position);
 
-  void SyncLedger();
-
   void TryRefreshTradingData();
 
-  void SyncTradingData();
-
   void SyncAppStates();
 
   void SyncStrategyStates();
@@ -307,27 +305,18 @@ private:
     return instruction.*id_ptr;
   }
 
-  template <typename DataType> void UpdateLedger(const boost::hana::basic_type<DataType> &type) {
-    using DataTypeMap = std::unordered_map<uint64_t, state<DataType>>;
-    auto &target_map = const_cast<DataTypeMap &>(data_bank_[type]);
-    auto iter = target_map.begin();
-    while (iter != target_map.end() and target_map.size() > 0) {
-      const auto &state = iter->second;
-      update_ledger(state.update_time, state.source, state.dest, state.data);
-      iter = target_map.erase(iter);
-    }
-  }
-
-  template <typename DataType> void UpdateTradingData(const boost::hana::basic_type<DataType> &type) {
+  template <typename DataType>
+  void UpdateDelta(const boost::hana::basic_type<DataType> &type, serialize::JsDeltaBatch &batch) {
     using DataTypeMap = std::unordered_map<uint64_t, state<DataType>>;
     auto &target_map = const_cast<DataTypeMap &>(data_bank_[type]);
-    auto iter = target_map.begin();
-    auto count = 0;
-    while (iter != target_map.end() and target_map.size() > 0 and count < TRANSFER_TRADING_DATA_LIMIT) {
-      const auto &state = iter->second;
-      update_ledger(state.update_time, state.source, state.dest, state.data);
-      iter = target_map.erase(iter);
-      count++;
+    if constexpr (size_fixed_v<DataType>) {
+      batch(target_map);
+    } else {
+      for (const auto &pair : target_map) {
+        const auto &state = pair.second;
+        update_ledger(state.update_time, state.source, state.dest, state.data);
+      }
+      target_map.clear();
     }
   }
 
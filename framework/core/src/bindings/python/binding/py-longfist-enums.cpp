@@ -235,6 +235,21 @@ void bind_enums(py::module &m) {
       .export_values()
       .def("__eq__", [](const StrategyState &a, int b) { return static_cast<int>(a) == b; });
 
+  py::enum_<LatencyHop>(m_enums, "LatencyHop", py::arithmetic())
+      .value("MdToInput", LatencyHop::MdToInput)
+      .value("InputToInsert", LatencyHop::InputToInsert)
+      .value("InsertToAck", LatencyHop::InsertToAck)
+      .value("InputToTrade", LatencyHop::InputToTrade)
+      .export_values()
+      .def("__eq__", [](const LatencyHop &a, int b) { return static_cast<int>(a) == b; });
+
+  py::enum_<BarType>(m_enums, "BarType", py::arithmetic())
+      .value("Time", BarType::Time)
+      .value("Volume", BarType::Volume)
+      .value("Turnover", BarType::Turnover)
+      .export_values()
+      .def("__eq__", [](const BarType &a, int b) { return static_cast<int>(a) == b; });
+
   py::enum_<MarketType>(m_enums, "MarketType", py::arithmetic())
       .value("All", MarketType::All)
       .value("BSE", MarketType::BSE)
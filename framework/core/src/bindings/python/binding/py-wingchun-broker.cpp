@@ -65,6 +65,8 @@ public:
     PYBIND11_OVERLOAD_PURE(void, Trader, on_time_key_value, event);
   }
 
+  void on_quote(const kungfu::event_ptr &event) override { PYBIND11_OVERLOAD(void, Trader, on_quote, event); }
+
   bool insert_batch_orders(const kungfu::event_ptr &event) override {
     PYBIND11_OVERLOAD(bool, Trader, insert_batch_orders, event);
   }
@@ -140,6 +142,7 @@ void bind_broker(pybind11::module &m) {
       .def("insert_order", &Trader::insert_order)
       .def("insert_batch_orders", &Trader::insert_batch_orders)
       .def("on_time_key_value", &Trader::on_time_key_value)
+      .def("on_quote", &Trader::on_quote)
       .def("cancel_order", &Trader::cancel_order)
       .def("req_history_order", &Trader::req_history_order)
       .def("req_history_trade", &Trader::req_history_trade)
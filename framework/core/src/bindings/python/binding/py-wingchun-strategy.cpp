@@ -20,6 +20,62 @@ using namespace kungfu::wingchun::book;
 namespace py = pybind11;
 
 namespace kungfu::wingchun::pybind {
+template <typename DataType> void bind_batch(pybind11::module &m, const char *name) {
+  using Batch = strategy::Batch<DataType>;
+  py::class_<Batch>(m, name)
+      .def("__len__", &Batch::size)
+      .def(
+          "__getitem__",
+          [](const Batch &batch, size_t index) -> const DataType & {
+            if (index >= batch.size()) {
+              throw py::index_error();
+            }
+            return batch[index];
+          },
+          py::return_value_policy::reference_internal)
+      .def(
+          "__iter__", [](const Batch &batch) { return py::make_iterator(batch.begin(), batch.end()); },
+          py::keep_alive<0, 1>())
+      .def("location", &Batch::location);
+}
+
+void bind_market_data_batch(pybind11::module &m) {
+  using strategy::MarketDataBatch;
+  py::class_<MarketDataBatch>(m, "MarketDataBatch")
+      .def("__len__", &MarketDataBatch::size)
+      .def("__getitem__",
+           [](const py::object &self, size_t index) -> py::object {
+             const auto &batch = self.cast<const MarketDataBatch &>();
+             if (index >= batch.size()) {
+               throw py::index_error();
+             }
+             auto policy = py::return_value_policy::reference_internal;
+             switch (batch.msg_type(index)) {
+             case Quote::tag:
+               return py::cast(batch.data<Quote>(index), policy, self);
+             case Entrust::tag:
+               return py::cast(batch.data<Entrust>(index), policy, self);
+             default:
+               return py::cast(batch.data<Transaction>(index), policy, self);
+             }
+           })
+      .def("msg_type", &MarketDataBatch::msg_type)
+      .def("location", &MarketDataBatch::location)
+      .def("quotes", &MarketDataBatch::all<Quote>, py::keep_alive<0, 1>())
+      .def("entrusts", &MarketDataBatch::all<Entrust>, py::keep_alive<0, 1>())
+      .def("transactions", &MarketDataBatch::all<Transaction>, py::keep_alive<0, 1>());
+}
+
+/**
+ * Default batch callback for python, delivers each item to the per item callback, without dispatching back to the
+ * batch callback overridden in python.
+ */
+template <typename DataType, auto OnMethod>
+void on_batch(strategy::Strategy &strategy, strategy::Context_ptr &context, const strategy::Batch<DataType> &batch) {
+  for (size_t i = 0; i < batch.size(); i++) {
+    (strategy.*OnMethod)(context, batch[i], batch.location(i));
+  }
+}
 
 class PyRunner : public strategy::Runner {
 public:
@@ -79,6 +135,24 @@ public:
     PYBIND11_OVERLOAD(void, strategy::Strategy, on_transaction, context, transaction, location);
   }
 
+  // batches are passed by pointer, so that python gets a view of them rather than a copy
+  void on_market_data(strategy::Context_ptr &context, const strategy::MarketDataBatch &batch) override {
+    overload_batch("on_market_data", context, batch, [&]() { strategy::Strategy::on_market_data(context, batch); });
+  }
+
+  void on_quotes(strategy::Context_ptr &context, const strategy::Batch<Quote> &quotes) override {
+    overload_batch("on_quotes", context, quotes, [&]() { strategy::Strategy::on_quotes(context, quotes); });
+  }
+
+  void on_entrusts(strategy::Context_ptr &context, const strategy::Batch<Entrust> &entrusts) override {
+    overload_batch("on_entrusts", context, entrusts, [&]() { strategy::Strategy::on_entrusts(context, entrusts); });
+  }
+
+  void on_transactions(strategy::Context_ptr &context, const strategy::Batch<Transaction> &transactions) override {
+    overload_batch("on_transactions", context, transactions,
+                   [&]() { strategy::Strategy::on_transactions(context, transactions); });
+  }
+
   void on_order(strategy::Context_ptr &context, const Order &order,
                 const kungfu::yijinjing::data::location_ptr &location) override {
     PYBIND11_OVERLOAD(void, strategy::Strategy, on_order, context, order, location);
@@ -142,9 +216,25 @@ public:
                       uint32_t length, const kungfu::yijinjing::data::location_ptr &location) override {
     PYBIND11_OVERLOAD(void, strategy::Strategy, on_custom_data, context, msg_type, data, length, location);
   }
+
+private:
+  template <typename BatchType, typename Fallback>
+  void overload_batch(const char *name, strategy::Context_ptr &context, const BatchType &batch, Fallback fallback) {
+    py::gil_scoped_acquire gil;
+    py::function overload = py::get_overload(static_cast<const strategy::Strategy *>(this), name);
+    if (overload) {
+      overload(context, &batch);
+      return;
+    }
+    fallback();
+  }
 };
 
 void bind_strategy(pybind11::module &m) {
+  bind_batch<Quote>(m, "QuoteBatch");
+  bind_batch<Entrust>(m, "EntrustBatch");
+  bind_batch<Transaction>(m, "TransactionBatch");
+  bind_market_data_batch(m);
 
   py::class_<strategy::Runner, PyRunner, kungfu::yijinjing::practice::apprentice, std::shared_ptr<strategy::Runner>>(
       m, "Runner")
@@ -196,7 +286,12 @@ void bind_strategy(pybind11::module &m) {
       .def("update_strategy_state", &strategy::Context::update_strategy_state)
       .def("get_writer", &strategy::Context::get_writer)
       .def("is_bypass_accounting", &strategy::Context::is_bypass_accounting)
-      .def("bypass_accounting", &strategy::Context::bypass_accounting);
+      .def("bypass_accounting", &strategy::Context::bypass_accounting)
+      .def("conflate_quotes", &strategy::Context::conflate_quotes)
+      .def("get_quote_conflation_threshold", &strategy::Context::get_quote_conflation_threshold)
+      .def("get_conflated_quote_count", &strategy::Context::get_conflated_quote_count)
+      .def("batch_market_data", &strategy::Context::batch_market_data)
+      .def("is_market_data_batched", &strategy::Context::is_market_data_batched);
 
   py::class_<strategy::RuntimeContext, strategy::Context, strategy::RuntimeContext_ptr>(m, "RuntimeContext")
       .def_property_readonly("bookkeeper", &strategy::RuntimeContext::get_bookkeeper,
@@ -216,6 +311,13 @@ void bind_strategy(pybind11::module &m) {
       .def("on_bar", &strategy::Strategy::on_bar)
       .def("on_entrust", &strategy::Strategy::on_entrust)
       .def("on_transaction", &strategy::Strategy::on_transaction)
+      .def("on_market_data",
+           [](strategy::Strategy &strategy, strategy::Context_ptr &context, const strategy::MarketDataBatch &batch) {
+             strategy.strategy::Strategy::on_market_data(context, batch);
+           })
+      .def("on_quotes", &on_batch<Quote, &strategy::Strategy::on_quote>)
+      .def("on_entrusts", &on_batch<Entrust, &strategy::Strategy::on_entrust>)
+      .def("on_transactions", &on_batch<Transaction, &strategy::Strategy::on_transaction>)
       .def("on_order", &strategy::Strategy::on_order)
       .def("on_order_action_error", &strategy::Strategy::on_order_action_error)
       .def("on_trade", &strategy::Strategy::on_trade)
@@ -2,6 +2,7 @@
 
 #include "py-yijinjing.h"
 
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include <kungfu/longfist/longfist.h>
@@ -9,6 +10,7 @@
 #include <kungfu/yijinjing/index/session.h>
 #include <kungfu/yijinjing/io.h>
 #include <kungfu/yijinjing/journal/assemble.h>
+#include <kungfu/yijinjing/journal/columnar.h>
 #include <kungfu/yijinjing/journal/frame.h>
 #include <kungfu/yijinjing/journal/journal.h>
 #include <kungfu/yijinjing/log.h>
@@ -70,6 +72,10 @@ class PyLocator : public locator {
   [[nodiscard]] std::vector<uint32_t> list_location_dest(const location_ptr &location) const override {
     PYBIND11_OVERLOAD(std::vector<uint32_t>, locator, list_location_dest, location);
   }
+
+  [[nodiscard]] uint32_t get_page_size(const location_ptr &location, uint32_t dest_id) const override {
+    PYBIND11_OVERLOAD(uint32_t, locator, get_page_size, location, dest_id);
+  }
 };
 
 class PyEvent : public event {
@@ -139,6 +145,65 @@ public:
 
 template <typename DataType> DataType event_to_data(const event &e) { return e.data<DataType>(); }
 
+/**
+ * Numpy structured dtype of records made of frame gen_time followed by the packed longfist data.
+ */
+template <typename DataType> py::dtype make_record_dtype() {
+  py::list names;
+  py::list formats;
+  py::list offsets;
+  names.append("gen_time");
+  formats.append(numpy_dtype<int64_t>());
+  offsets.append(0);
+  DataType sample = {};
+  auto base = reinterpret_cast<uintptr_t>(&sample);
+  boost::hana::for_each(boost::hana::accessors<DataType>(), [&](auto it) {
+    auto accessor = boost::hana::second(it);
+    using AttrType = std::decay_t<decltype(accessor(sample))>;
+    auto dtype = numpy_field_dtype<AttrType>();
+    names.append(boost::hana::first(it).c_str());
+    formats.append(dtype.second > 1 ? fmt::format("({},){}", dtype.second, dtype.first) : dtype.first);
+    offsets.append(sizeof(int64_t) + reinterpret_cast<uintptr_t>(&accessor(sample)) - base);
+  });
+  py::dict spec;
+  spec["names"] = names;
+  spec["formats"] = formats;
+  spec["offsets"] = offsets;
+  spec["itemsize"] = sizeof(int64_t) + sizeof(DataType);
+  return py::dtype::from_args(spec);
+}
+
+/**
+ * Read frames of DataType within [begin_time, end_time) into one contiguous buffer, and expose it as numpy structured
+ * array without further copy. Frames are filtered in C++ with GIL released.
+ */
+template <typename DataType, typename Source>
+py::array read_array(Source &source, int32_t msg_type, int64_t begin_time, int64_t end_time) {
+  constexpr size_t record_size = sizeof(int64_t) + sizeof(DataType);
+  auto buffer = std::make_unique<std::vector<uint8_t>>();
+  {
+    py::gil_scoped_release release;
+    while (source.data_available() and source.current_frame()->gen_time() < end_time) {
+      auto frame = source.current_frame();
+      if (frame->msg_type() == msg_type and frame->gen_time() >= begin_time) {
+        auto gen_time = frame->gen_time();
+        auto offset = buffer->size();
+        buffer->resize(offset + record_size);
+        memcpy(buffer->data() + offset, &gen_time, sizeof(int64_t));
+        memcpy(buffer->data() + offset + sizeof(int64_t), frame->data_address(),
+               std::min<size_t>(frame->data_length(), sizeof(DataType)));
+      }
+      source.next();
+    }
+  }
+  std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(buffer->size() / record_size)};
+  std::vector<py::ssize_t> strides = {static_cast<py::ssize_t>(record_size)};
+  auto data = buffer->data();
+  py::capsule owner(buffer.get(), [](void *p) { delete reinterpret_cast<std::vector<uint8_t> *>(p); });
+  buffer.release();
+  return py::array(make_record_dtype<DataType>(), shape, strides, data, owner);
+}
+
 void bind(pybind11::module &&m) {
   yijinjing::ensure_sqlite_initilize();
 
@@ -178,7 +243,8 @@ void bind(pybind11::module &&m) {
       .def_property_readonly("msg_type", &event::msg_type)
       .def_property_readonly("data_length", &event::data_length)
       .def_property_readonly("data_as_bytes", &event::data_as_bytes)
-      .def_property_readonly("data_as_string", &event::data_as_string)
+      // bytes rather than str, payloads of unfixed size types are binary, json.loads still takes older json ones
+      .def_property_readonly("data_as_string", [](const event &e) { return py::bytes(e.data_as_string()); })
       .def("to_string", &event::to_string);
   boost::hana::for_each(AllDataTypes, [&](auto pair) {
     using DataType = typename decltype(+boost::hana::second(pair))::type;
@@ -216,7 +282,8 @@ void bind(pybind11::module &&m) {
       .def("list_page_id", &locator::list_page_id)
       .def("list_locations", &locator::list_locations, py::arg("category") = "*", py::arg("group") = "*",
            py::arg("name") = "*", py::arg("mode") = "*")
-      .def("list_location_dest", &locator::list_location_dest);
+      .def("list_location_dest", &locator::list_location_dest)
+      .def("get_page_size", &locator::get_page_size);
 
   py::class_<socket, socket_ptr>(m, "socket")
       .def(py::init<protocol>(), py::arg("protocol"))
@@ -239,8 +306,8 @@ void bind(pybind11::module &&m) {
       .def("wait", &observer::wait)
       .def("get_notice", &observer::get_notice);
 
-  py::class_<reader, reader_ptr>(m, "reader")
-      .def("subscribe", &reader::join)
+  auto reader_class = py::class_<reader, reader_ptr>(m, "reader");
+  reader_class.def("subscribe", &reader::join)
       .def("current_frame", &reader::current_frame)
       .def("seek_to_time", &reader::seek_to_time)
       .def("data_available", &reader::data_available)
@@ -275,6 +342,20 @@ void bind(pybind11::module &&m) {
       .def(py::init<data::locator_ptr>())
       .def("put", &copy_sink::put);
 
+  py::class_<columnar_sink, sink, columnar_sink_ptr>(m, "columnar_sink")
+      .def(py::init<std::string, const std::vector<std::string> &, int64_t, int64_t, const std::vector<std::string> &>(),
+           py::arg("output_dir"), py::arg("type_names"), py::arg("begin_time") = 0, py::arg("end_time") = INT64_MAX,
+           py::arg("instrument_ids") = std::vector<std::string>{})
+      .def_property_readonly("rows", &columnar_sink::get_rows)
+      .def("put", &columnar_sink::put)
+      .def("close", &columnar_sink::close);
+
+  m.def("export_columnar", &export_columnar, py::arg("locator"), py::arg("output_dir"), py::arg("type_names"),
+        py::arg("begin_time") = 0, py::arg("end_time") = INT64_MAX,
+        py::arg("instrument_ids") = std::vector<std::string>{}, py::arg("mode") = "*", py::arg("category") = "*",
+        py::arg("group") = "*", py::arg("name") = "*", py::arg("thread_count") = 0,
+        py::call_guard<py::gil_scoped_release>());
+
   auto assemble_class = py::class_<assemble, assemble_ptr>(m, "assemble");
   assemble_class
       .def(py::init<const std::vector<data::locator_ptr> &, const std::string &, const std::string &,
@@ -304,6 +385,20 @@ void bind(pybind11::module &&m) {
                        py::arg("data") = DataType{}, py::arg("end_time") = INT64_MAX, py::return_value_policy::move);
     assemble_class.def("read_bytes", py::overload_cast<const DataType &, int64_t>(&assemble::read_bytes<DataType>),
                        py::arg("data") = DataType{}, py::arg("end_time") = INT64_MAX, py::return_value_policy::move);
+    if constexpr (size_fixed_v<DataType> and DataType::has_data) {
+      assemble_class.def(
+          "read_array",
+          [](assemble &asb, const DataType &, int64_t begin_time, int64_t end_time) {
+            return read_array<DataType>(asb, DataType::tag, begin_time, end_time);
+          },
+          py::arg("data"), py::arg("begin_time") = 0, py::arg("end_time") = INT64_MAX);
+      reader_class.def(
+          "read_array",
+          [](reader &r, const DataType &, int64_t begin_time, int64_t end_time) {
+            return read_array<DataType>(r, DataType::tag, begin_time, end_time);
+          },
+          py::arg("data"), py::arg("begin_time") = 0, py::arg("end_time") = INT64_MAX);
+    }
   });
 
   py::class_<io_device, io_device_ptr>(m, "io_device")
@@ -340,7 +435,8 @@ void bind(pybind11::module &&m) {
 
   py::class_<session_builder, session_finder, std::shared_ptr<session_builder>>(m, "session_builder")
       .def(py::init<io_device_ptr>())
-      .def("rebuild_index_db", &session_builder::rebuild_index_db);
+      .def("rebuild_index_db", &session_builder::rebuild_index_db, py::arg("incremental") = true,
+           py::arg("thread_count") = 0);
 
   auto profile_class = py::class_<profile, std::shared_ptr<profile>>(m, "profile");
   profile_class.def(py::init<const locator_ptr &>());
@@ -7,6 +7,7 @@
 #ifndef KUNGFU_COMMON_H
 #define KUNGFU_COMMON_H
 
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <sstream>
@@ -328,15 +329,25 @@ template <typename DataType> struct data {
     });
   }
 
+  /**
+   * Restore members from bytes written by to_bytes, or from json text as written by to_string.
+   */
   void parse(const char *address, const uint32_t length) {
+    if (length > 0 and address[0] == BINARY_MARK) {
+      parse_bytes(address, length);
+      return;
+    }
     std::string content(address, length);
     nlohmann::json jobj = nlohmann::json::parse(content);
     boost::hana::for_each(boost::hana::accessors<DataType>(), [&, this](auto it) {
       auto name = boost::hana::first(it);
       auto accessor = boost::hana::second(it);
-      auto &j = jobj[name.c_str()];
+      auto found = jobj.find(name.c_str());
+      if (found == jobj.end()) {
+        return; // written before the member was added, keeps its initial value
+      }
       auto &v = accessor(*const_cast<DataType *>(reinterpret_cast<const DataType *>(this)));
-      restore_from_json(j, v);
+      restore_from_json(*found, v);
     });
   }
 
@@ -350,6 +361,28 @@ template <typename DataType> struct data {
     return j.dump(-1, ' ', false, nlohmann::json::basic_json::error_handler_t::replace);
   }
 
+  /**
+   * Compact binary form written to journal for types of unfixed size, parsed back by parse.
+   * After BINARY_MARK comes each member as key (hash of member name), length and value bytes. Members are matched by
+   * key, so schema evolves the same way as with json: unknown members are skipped, missing ones keep initial values.
+   */
+  [[nodiscard]] std::string to_bytes() const {
+    static_assert(has_unique_member_keys(), "members of a type have the same member key, rename one of them");
+    std::string bytes(1, BINARY_MARK);
+    boost::hana::for_each(boost::hana::accessors<DataType>(), [&, this](auto it) {
+      auto name = boost::hana::first(it);
+      auto accessor = boost::hana::second(it);
+      constexpr uint32_t key = member_key(decltype(name)::c_str());
+      auto offset = bytes.length();
+      bytes.append(2 * sizeof(uint32_t), '\0');
+      encode_member(bytes, accessor(*reinterpret_cast<const DataType *>(this)));
+      uint32_t length = bytes.length() - offset - 2 * sizeof(uint32_t);
+      memcpy(bytes.data() + offset, &key, sizeof(key));
+      memcpy(bytes.data() + offset + sizeof(key), &length, sizeof(length));
+    });
+    return bytes;
+  }
+
   explicit operator std::string() const { return to_string(); }
 
   [[nodiscard]] uint64_t uid() const {
@@ -364,6 +397,108 @@ template <typename DataType> struct data {
   }
 
 private:
+  static constexpr char BINARY_MARK = '\x01'; // json text always starts with '{'
+
+  static constexpr uint32_t member_key(const char *name) {
+    uint32_t key = 2166136261u; // FNV-1a
+    for (; *name != '\0'; name++) {
+      key = (key ^ static_cast<uint8_t>(*name)) * 16777619u;
+    }
+    return key;
+  }
+
+  /**
+   * Two member names of a type could hash to the same key, which would decode one member into the other.
+   */
+  static constexpr bool has_unique_member_keys() {
+    constexpr auto names = boost::hana::transform(boost::hana::accessors<DataType>(), boost::hana::first);
+    return boost::hana::unpack(names, [](auto... name) {
+      std::array<uint32_t, sizeof...(name)> keys = {member_key(decltype(name)::c_str())...};
+      for (size_t i = 0; i < keys.size(); i++) {
+        for (size_t j = i + 1; j < keys.size(); j++) {
+          if (keys[i] == keys[j]) {
+            return false;
+          }
+        }
+      }
+      return true;
+    });
+  }
+
+  template <typename V> static void encode_member(std::string &bytes, const V &v) {
+    if constexpr (std::is_arithmetic_v<V> or std::is_enum_v<V>) {
+      std::remove_cv_t<V> value = v; // members like frame_header::length are volatile
+      bytes.append(reinterpret_cast<const char *>(&value), sizeof(V));
+    } else if constexpr (is_array_of_v<V, char>) {
+      bytes.append(v.value, strnlen(v.value, V::length));
+    } else if constexpr (is_array_v<V>) {
+      bytes.append(reinterpret_cast<const char *>(v.value), sizeof(v.value));
+    } else if constexpr (std::is_same_v<V, std::string>) {
+      bytes.append(v);
+    } else {
+      bytes.append(nlohmann::json(v).dump());
+    }
+  }
+
+  template <typename V> static void decode_member(V &v, const char *value, uint32_t length) {
+    if constexpr (std::is_arithmetic_v<V> or std::is_enum_v<V>) {
+      if (length == sizeof(V)) {
+        std::remove_cv_t<V> decoded;
+        memcpy(&decoded, value, sizeof(V));
+        v = decoded;
+      }
+    } else if constexpr (is_array_v<V>) {
+      memcpy(v.value, value, std::min<size_t>(length, sizeof(v.value)));
+    } else if constexpr (std::is_same_v<V, std::string>) {
+      v.assign(value, length);
+    } else {
+      nlohmann::json::parse(value, value + length).get_to(v);
+    }
+  }
+
+  /**
+   * Find member of key in bytes, starting from cursor and wrapping around, as members are usually in declared order.
+   * @return address of the value, nullptr if not found
+   */
+  static const char *find_member(const char *begin, const char *end, const char *&cursor, uint32_t key,
+                                 uint32_t &length) {
+    for (auto [from, to] : {std::pair{cursor, end}, std::pair{begin, cursor}}) {
+      while (from + 2 * sizeof(uint32_t) <= to) {
+        uint32_t member = 0;
+        memcpy(&member, from, sizeof(member));
+        memcpy(&length, from + sizeof(member), sizeof(length));
+        auto value = from + 2 * sizeof(uint32_t);
+        if (length > static_cast<size_t>(end - value)) {
+          return nullptr; // truncated
+        }
+        if (member == key) {
+          cursor = value + length;
+          return value;
+        }
+        from = value + length;
+      }
+    }
+    return nullptr;
+  }
+
+  void parse_bytes(const char *address, const uint32_t length) {
+    static_assert(has_unique_member_keys(), "members of a type have the same member key, rename one of them");
+    auto begin = address + 1;
+    auto end = address + length;
+    auto cursor = begin;
+    boost::hana::for_each(boost::hana::accessors<DataType>(), [&, this](auto it) {
+      auto name = boost::hana::first(it);
+      auto accessor = boost::hana::second(it);
+      constexpr uint32_t key = member_key(decltype(name)::c_str());
+      uint32_t value_length = 0;
+      auto value = find_member(begin, end, cursor, key, value_length);
+      if (value != nullptr) {
+        decode_member(accessor(*const_cast<DataType *>(reinterpret_cast<const DataType *>(this))), value,
+                      value_length);
+      }
+    });
+  }
+
   template <typename V> static std::enable_if_t<is_numeric_v<V>> init_member(V &v) { v = static_cast<V>(0); }
 
   template <typename V> static std::enable_if_t<not is_numeric_v<V>> init_member(V &) {}
@@ -410,6 +545,10 @@ struct event {
 
   [[nodiscard]] virtual const char *data_as_bytes() const = 0;
 
+  /**
+   * Payload as is, all data_length bytes of it. Types of unfixed size are written in the binary form of
+   * data::to_bytes, so it is json text only for frames written before that; decode them with data<T>() instead.
+   */
   [[nodiscard]] virtual std::string data_as_string() const = 0;
 
   [[nodiscard]] virtual std::string to_string() const = 0;
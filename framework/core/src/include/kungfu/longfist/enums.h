@@ -561,6 +561,27 @@ NLOHMANN_JSON_SERIALIZE_ENUM(StrategyState, {
 
 inline std::ostream &operator<<(std::ostream &os, StrategyState t) { return os << int8_t(t); }
 
+enum class LatencyHop : int8_t { MdToInput, InputToInsert, InsertToAck, InputToTrade };
+
+NLOHMANN_JSON_SERIALIZE_ENUM(LatencyHop, {
+                                             {LatencyHop::MdToInput, "MdToInput"},
+                                             {LatencyHop::InputToInsert, "InputToInsert"},
+                                             {LatencyHop::InsertToAck, "InsertToAck"},
+                                             {LatencyHop::InputToTrade, "InputToTrade"},
+                                         })
+
+inline std::ostream &operator<<(std::ostream &os, LatencyHop t) { return os << int8_t(t); }
+
+enum class BarType : int8_t { Time, Volume, Turnover };
+
+NLOHMANN_JSON_SERIALIZE_ENUM(BarType, {
+                                          {BarType::Time, "Time"},
+                                          {BarType::Volume, "Volume"},
+                                          {BarType::Turnover, "Turnover"},
+                                      })
+
+inline std::ostream &operator<<(std::ostream &os, BarType t) { return os << int8_t(t); }
+
 class AssembleMode {
 public:
   inline static const uint32_t Channel = 0b00000001; // read only journal of location to dest_id
@@ -28,6 +28,7 @@ constexpr auto AllTypes = boost::hana::make_map( //
     TYPE_PAIR(RequestCached),                    //
     TYPE_PAIR(CachedReadyToRead),                //
     TYPE_PAIR(RequestCachedDone),                //
+    TYPE_PAIR(Bootstrap),                        //
     TYPE_PAIR(CustomSubscribe),                  //
     TYPE_PAIR(NewOrderSingle),                   //
     TYPE_PAIR(CancelOrder),                      //
@@ -52,6 +53,7 @@ constexpr auto AllTypes = boost::hana::make_map( //
     TYPE_PAIR(StrategyStateUpdate),              //
     TYPE_PAIR(Commission),                       //
     TYPE_PAIR(Session),                          //
+    TYPE_PAIR(SessionIndex),                     //
     TYPE_PAIR(Location),                         //
     TYPE_PAIR(Register),                         //
     TYPE_PAIR(Deregister),                       //
@@ -90,6 +92,7 @@ constexpr auto AllTypes = boost::hana::make_map( //
     TYPE_PAIR(Position),                         //
     TYPE_PAIR(PositionEnd),                      //
     TYPE_PAIR(OrderStat),                        //
+    TYPE_PAIR(LatencyStat),                      //
     TYPE_PAIR(BasketOrder),                      //
     TYPE_PAIR(RequestHistoryOrder),              //
     TYPE_PAIR(RequestHistoryOrderError),         //
@@ -107,6 +110,7 @@ constexpr auto AllTypes = boost::hana::make_map( //
     TYPE_PAIR(StrategyStateUpdate),                                   //
     TYPE_PAIR(Commission),                                            //
     TYPE_PAIR(Session),                                               //
+    TYPE_PAIR(SessionIndex),                                          //
     TYPE_PAIR(Location),                                              //
     TYPE_PAIR(Register),                                              //
     TYPE_PAIR(Deregister),                                            //
@@ -145,6 +149,7 @@ constexpr auto AllTypes = boost::hana::make_map( //
     TYPE_PAIR(Position),                                              //
     TYPE_PAIR(PositionEnd),                                           //
     TYPE_PAIR(OrderStat),                                             //
+    TYPE_PAIR(LatencyStat),                                           //
     TYPE_PAIR(BasketOrder)                                            //
 );
 
@@ -159,7 +164,8 @@ constexpr auto ProfileDataTypes = boost::hana::make_map( //
 );
 
 constexpr auto SessionDataTypes = boost::hana::make_map( //
-    TYPE_PAIR(Session)                                   //
+    TYPE_PAIR(Session),                                  //
+    TYPE_PAIR(SessionIndex)                              //
 );
 
 constexpr auto StateDataTypes = boost::hana::make_map( //
@@ -183,6 +189,7 @@ constexpr auto StateDataTypes = boost::hana::make_map( //
     TYPE_PAIR(AssetMargin),                            //
     TYPE_PAIR(Position),                               //
     TYPE_PAIR(OrderStat),                              //
+    TYPE_PAIR(LatencyStat),                            //
     TYPE_PAIR(BasketOrder)                             //
 );
 
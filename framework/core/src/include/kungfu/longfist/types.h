@@ -20,6 +20,7 @@ static constexpr int TRAIDNG_PHASE_CODE_LEN = 8;
 static constexpr int ERROR_MSG_LEN = 256;
 static constexpr int EXTERNAL_ID_LEN = 32;
 static constexpr int OPPONENT_SEAT_LEN = 16;
+static constexpr int LATENCY_BUCKET_COUNT = 528;
 
 KF_DEFINE_MARK_TYPE(PageEnd, 10000);
 KF_DEFINE_MARK_TYPE(SessionStart, 10001);
@@ -33,6 +34,7 @@ KF_DEFINE_MARK_TYPE(RequestStop, 10024);
 KF_DEFINE_MARK_TYPE(RequestStart, 10025);
 KF_DEFINE_MARK_TYPE(CachedReadyToRead, 10060);
 KF_DEFINE_MARK_TYPE(RequestCached, 10061);
+KF_DEFINE_MARK_TYPE(Bootstrap, 10063);
 KF_DEFINE_MARK_TYPE(NewOrderSingle, 353);
 KF_DEFINE_MARK_TYPE(CancelOrder, 354);
 KF_DEFINE_MARK_TYPE(CancelAllOrder, 355);
@@ -140,6 +142,14 @@ KF_DEFINE_DATA_TYPE(                                                     //
     (uint64_t, data_size)                                                //
 );
 
+KF_DEFINE_DATA_TYPE(                                         //
+    SessionIndex, 10015, PK(location_uid, dest_id), PERPETUAL(), //
+    (uint32_t, location_uid),                                    //
+    (uint32_t, dest_id),                                         //
+    (uint32_t, page_id),                                         //
+    (int64_t, frame_time)                                        //
+);
+
 KF_DEFINE_DATA_TYPE(                                //
     Register, 10011, PK(location_uid), PERPETUAL(), //
     (uint32_t, location_uid),                       //
@@ -149,7 +159,8 @@ KF_DEFINE_DATA_TYPE(                                //
     (std::string, name),                            //
     (int32_t, pid),                                 //
     (int64_t, last_active_time),                    //
-    (int64_t, checkin_time)                         //
+    (int64_t, checkin_time),                        //
+    (std::string, placement)                        //
 );
 
 KF_DEFINE_DATA_TYPE(                                  //
@@ -477,8 +488,8 @@ KF_DEFINE_PACK_TYPE(                                        //
 
 );
 
-KF_DEFINE_PACK_TYPE(                                                 //
-    Bar, 110, PK(instrument_id, exchange_id), TIMESTAMP(start_time), //
+KF_DEFINE_PACK_TYPE(                                                                     //
+    Bar, 110, PK(instrument_id, exchange_id, bar_type, interval), TIMESTAMP(start_time), //
     (kungfu::array<char, DATE_LEN>, trading_day),                    // 交易日
     (kungfu::array<char, INSTRUMENT_ID_LEN>, instrument_id),         // 合约代码
     (kungfu::array<char, EXCHANGE_ID_LEN>, exchange_id),             // 交易所代码
@@ -496,7 +507,10 @@ KF_DEFINE_PACK_TYPE(                                                 //
     (int64_t, volume),       // 区间交易量
     (int64_t, start_volume), // 初始总交易量
 
-    (int32_t, tick_count) // 区间有效tick数
+    (int32_t, tick_count), // 区间有效tick数
+
+    (enums::BarType, bar_type), // bar类型, 按时间/成交量/成交额切分
+    (int64_t, interval)         // 切分间隔, 时间bar为纳秒, 成交量bar为股数, 成交额bar为元
 );
 
 KF_DEFINE_PACK_TYPE(                                       //
@@ -812,6 +826,27 @@ KF_DEFINE_PACK_TYPE(                                  //
     (double, avg_price)                               //
 );
 
+KF_DEFINE_PACK_TYPE(                                                              //
+    LatencyStat, 217, PK(strategy_uid, account_uid, hop), TIMESTAMP(update_time), //
+    (uint32_t, strategy_uid),                                                     // 策略
+    (uint32_t, account_uid),                                                      // 账户
+    (enums::LatencyHop, hop),                                                     // 延迟环节
+
+    (int64_t, update_time), // 统计窗口结束时间
+    (int64_t, window),      // 统计窗口长度
+
+    (int64_t, count), // 样本数
+    (int64_t, min),   // 最小值
+    (int64_t, max),   // 最大值
+    (double, mean),   // 平均值
+    (int64_t, p50),   // 50分位
+    (int64_t, p90),   // 90分位
+    (int64_t, p99),   // 99分位
+    (int64_t, p999),  // 99.9分位
+
+    (kungfu::array<uint32_t, LATENCY_BUCKET_COUNT>, buckets) // 对数线性分桶计数, 见yijinjing::util::histogram
+);
+
 KF_DEFINE_PACK_TYPE(                                        //
     BasketOrder, 220, PK(order_id), TIMESTAMP(insert_time), //
     (uint64_t, order_id),                                   // 篮子单uid
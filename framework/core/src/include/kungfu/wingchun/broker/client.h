@@ -124,6 +124,16 @@ public:
 
   [[nodiscard]] virtual bool should_connect_system(const yijinjing::data::location_ptr &system_location) const = 0;
 
+  /**
+   * Tells whether to read the band written by given MD.
+   * Market data shard bands are read only if they carry subscribed instruments, other bands are always read.
+   * @param md_location MD location
+   * @param band_location band location
+   * @return true if should connect
+   */
+  [[nodiscard]] virtual bool should_connect_band(const yijinjing::data::location_ptr &md_location,
+                                                 const yijinjing::data::location_ptr &band_location) const;
+
   [[nodiscard]] kungfu::yijinjing::data::location_ptr get_location(uint32_t uid) const {
     return app_.get_location(uid);
   }
@@ -131,6 +141,8 @@ public:
 protected:
   yijinjing::practice::apprentice &app_;
 
+  void connect_bands(int64_t trigger_time, const yijinjing::data::location_ptr &md_location);
+
 private:
   BrokerStateMap broker_states_ = {};
   InstrumentKeyMap instrument_keys_ = {};
@@ -138,6 +150,8 @@ private:
   InstrumentSourceMap instrument_md_locations_ = {};
   yijinjing::data::location_map ready_md_locations_ = {};
   yijinjing::data::location_map ready_td_locations_ = {};
+  std::unordered_map<uint32_t, yijinjing::data::location_map> md_bands_ = {};
+  yijinjing::data::location_map connected_bands_ = {};
 
   void update_broker_state(const event_ptr &event, const longfist::types::BrokerStateUpdate &state);
 
@@ -192,6 +206,9 @@ public:
 
   // [[nodiscard]] bool is_subscribed(const std::string &exchange_id, const std::string &instrument_id) const override;
 
+  [[nodiscard]] bool should_connect_band(const yijinjing::data::location_ptr &md_location,
+                                         const yijinjing::data::location_ptr &band_location) const override;
+
   void renew(int64_t trigger_time, const yijinjing::data::location_ptr &md_location) override;
 
   void sync(int64_t trigger_time, const yijinjing::data::location_ptr &td_location) override;
@@ -64,8 +64,26 @@ protected:
 
   void add_instrument_key(const longfist::types::InstrumentKey &key);
 
+  /**
+   * Shard market data by instrument hash into bands, so that clients only read the shards of their subscriptions.
+   * @param shard_count number of shards, 0 to keep all market data in public journal
+   */
+  void request_md_shards(uint32_t shard_count);
+
+  /**
+   * Get writer for market data of given instrument.
+   * Falls back to public journal if not sharded or the shard writer is not opened yet.
+   * @param exchange_id exchange ID
+   * @param instrument_id instrument ID
+   * @return writer of the shard, or public writer
+   */
+  [[nodiscard]] yijinjing::journal::writer_ptr get_md_writer(const char *exchange_id, const char *instrument_id) const;
+
   std::unordered_map<std::string, longfist::types::Instrument> instruments_ = {};
   std::vector<longfist::types::InstrumentKey> instruments_to_subscribe_{};
+
+private:
+  std::vector<uint32_t> md_shard_uids_ = {};
 };
 } // namespace kungfu::wingchun::broker
 
@@ -76,6 +76,9 @@ public:
 
   virtual void on_time_key_value(const event_ptr &event) { return; }
 
+  /// 收到行情时调用, 仅当本柜台通过 request_read_from_public 读取了行情源时才会有行情到达, 供模拟柜台撮合使用.
+  virtual void on_quote(const event_ptr &event) { return; }
+
   /// 此函数自动发送一个空的AssetMargin数据. 两融柜台需要发送一个存有数据的AssetMargin, 请override此函数取消写入.
   /// 并且在使用writer写入完AssetMargin之后调用enable_asset_margin_sync()函数.
   /// 非两融柜台想要取消日志输出请override此函数.
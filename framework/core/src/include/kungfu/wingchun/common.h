@@ -552,6 +552,21 @@ inline uint32_t hash_account(const std::string &source_name, const std::string &
   return yijinjing::util::hash_str_32(source_name) ^ yijinjing::util::hash_str_32(account_id);
 }
 
+/**
+ * Market data shards are bands named md-shard-{shard}-{shard_count}, each carries the instruments hashed into it.
+ */
+inline std::string get_md_shard_name(uint32_t shard, uint32_t shard_count) {
+  return fmt::format("md-shard-{}-{}", shard, shard_count);
+}
+
+inline uint32_t get_md_shard(const char *exchange_id, const char *instrument_id, uint32_t shard_count) {
+  return hash_instrument(exchange_id, instrument_id) % shard_count;
+}
+
+inline bool parse_md_shard_name(const std::string &name, uint32_t &shard, uint32_t &shard_count) {
+  return sscanf(name.c_str(), "md-shard-%u-%u", &shard, &shard_count) == 2 and shard < shard_count;
+}
+
 inline void order_from_input(const longfist::types::OrderInput &input, longfist::types::Order &order) {
   order.order_id = input.order_id;
 
@@ -1,12 +1,73 @@
 #ifndef KF_SERVICE_BAR_GENERATOR
 #define KF_SERVICE_BAR_GENERATOR
 
-#include <unordered_set>
+#include <functional>
+#include <unordered_map>
 
 #include <kungfu/longfist/longfist.h>
 #include <kungfu/wingchun/broker/marketdata.h>
 
 namespace kungfu::wingchun::service {
+struct BarSpec {
+  longfist::enums::BarType type;
+  int64_t time_interval;
+  int64_t volume_threshold;
+  double turnover_threshold;
+};
+
+/**
+ * Aggregates ticks into bars for every spec of every instrument in one pass, without any io.
+ * Bar states are laid out flat as bars_[slot * specs_.size() + spec_index], one slot per instrument.
+ * Each bar carries bar_type and interval of its spec, so bars of different specs have different keys.
+ */
+class BarAggregator {
+public:
+  typedef std::function<void(int64_t gen_time, const longfist::types::Bar &bar)> BarHandler;
+
+  BarAggregator(std::vector<BarSpec> specs, BarHandler handler);
+
+  void on_quote(int64_t gen_time, const longfist::types::Quote &quote);
+
+  void on_transaction(int64_t gen_time, const longfist::types::Transaction &transaction);
+
+  [[nodiscard]] const std::vector<BarSpec> &get_specs() const;
+
+  [[nodiscard]] size_t get_instrument_count() const;
+
+  [[nodiscard]] int64_t get_tick_count() const;
+
+  [[nodiscard]] int64_t get_bar_count() const;
+
+private:
+  std::vector<BarSpec> specs_;
+  BarHandler handler_;
+  std::unordered_map<uint32_t, size_t> slots_ = {};
+  std::vector<longfist::types::Bar> bars_ = {};
+  std::vector<double> bar_start_turnovers_ = {};
+  std::vector<int64_t> total_volumes_ = {};
+  std::vector<double> total_turnovers_ = {};
+  int64_t tick_count_ = 0;
+  int64_t bar_count_ = 0;
+
+  size_t find_slot(const char *exchange_id, const char *instrument_id, longfist::enums::InstrumentType type,
+                   const char *trading_day);
+
+  void on_tick(int64_t gen_time, size_t slot, int64_t data_time, double price, int64_t tick_volume,
+               double tick_turnover);
+
+  void update_time_bar(int64_t gen_time, const BarSpec &spec, longfist::types::Bar &bar, int64_t data_time,
+                       double price, int64_t total_volume, int64_t tick_volume);
+
+  void update_size_bar(int64_t gen_time, const BarSpec &spec, longfist::types::Bar &bar, double &start_turnover,
+                       int64_t data_time, double price, int64_t total_volume, double total_turnover);
+
+  void write_bar(int64_t gen_time, const longfist::types::Bar &bar);
+};
+
+/**
+ * Generates bars for every spec of every instrument of the source, and writes them to its public journal.
+ * Ticks are quotes by default, or transactions if config "tick_source" is "transaction".
+ */
 class BarGenerator : public broker::MarketDataVendor {
 public:
   BarGenerator(const yijinjing::data::locator_ptr &locator, longfist::enums::mode m, bool low_latency,
@@ -14,10 +75,15 @@ public:
 
   void on_start() override;
 
+  void on_exit() override;
+
 private:
-  int64_t time_interval_;
   yijinjing::data::location_ptr source_location_;
-  std::unordered_map<uint32_t, longfist::types::Bar> bars_;
+  bool use_transaction_ = false;
+  std::unique_ptr<BarAggregator> aggregator_;
+  int64_t first_tick_time_ = 0;
+
+  void on_tick(int64_t gen_time);
 };
 } // namespace kungfu::wingchun::service
 
@@ -12,6 +12,7 @@
 #include <kungfu/yijinjing/io.h>
 #include <kungfu/yijinjing/log.h>
 #include <kungfu/yijinjing/practice/apprentice.h>
+#include <kungfu/yijinjing/util/histogram.h>
 
 namespace kungfu::wingchun::service {
 
@@ -21,6 +22,17 @@ class Ledger : public yijinjing::practice::apprentice {
   typedef std::unordered_map<uint32_t, longfist::types::BrokerStateUpdate> BrokerStateMap;
   typedef std::unordered_map<uint32_t, longfist::types::Position> PositionMap;
 
+  static constexpr size_t LATENCY_HOP_COUNT = 4;
+
+  /**
+   * Latency histograms of orders from one strategy to one account, one for each hop, reset after every publish.
+   */
+  struct LatencyBook {
+    uint32_t strategy_uid;
+    uint32_t account_uid;
+    std::array<yijinjing::util::histogram, LATENCY_HOP_COUNT> hops;
+  };
+
 public:
   explicit Ledger(yijinjing::data::locator_ptr locator, longfist::enums::mode m, bool low_latency = false);
 
@@ -41,6 +53,8 @@ private:
   book::BookMap tmp_books_;
   std::unordered_map<uint64_t, state<longfist::types::OrderStat>> order_stats_ = {};
   BrokerStateMap broker_states_ = {};
+  std::unordered_map<uint64_t, LatencyBook> latency_books_ = {};
+  int64_t latency_window_start_ = 0;
 
   void update_broker_state_map(uint32_t location_uid, const longfist::types::BrokerStateUpdate &brokerStateUpdate);
 
@@ -58,6 +72,10 @@ private:
 
   void update_order_stat(const event_ptr &event, const longfist::types::Trade &data);
 
+  void record_latency(uint32_t strategy_uid, uint32_t account_uid, longfist::enums::LatencyHop hop, int64_t latency);
+
+  void write_latency_stats(int64_t trigger_time);
+
   void update_account_book(int64_t trigger_time, uint32_t account_uid);
 
   void inspect_channel(int64_t trigger_time, const longfist::types::Channel &channel);
@@ -15,6 +15,8 @@
 #include <kungfu/yijinjing/practice/apprentice.h>
 
 namespace kungfu::wingchun::strategy {
+class Runner;
+
 class Context : public std::enable_shared_from_this<Context> {
 public:
   Context() = default;
@@ -217,6 +219,48 @@ public:
    */
   bool is_bypass_accounting() const;
 
+  /**
+   * Call to conflate quotes when lagging behind.
+   * When the runner falls behind the journal by more than lag_threshold, intermediate quotes of the same instrument
+   * are skipped and only the latest one is delivered to on_quote. Orders, trades and level 2 data are never conflated.
+   * Latest quotes are delivered once the runner catches up, before any event other than a quote, such as an entrust,
+   * transaction, tree, order or trade, and at least once every lag_threshold or 4096 quotes while it stays behind.
+   * @param lag_threshold lag threshold in nano seconds, 0 to disable
+   */
+  void conflate_quotes(int64_t lag_threshold);
+
+  /**
+   * Get quote conflation lag threshold.
+   * @return lag threshold in nano seconds, 0 if conflation is disabled. Defaults to 0.
+   */
+  [[nodiscard]] int64_t get_quote_conflation_threshold() const;
+
+  /**
+   * Get the number of quotes skipped by conflation for given instrument.
+   * @param exchange_id exchange ID
+   * @param instrument_id instrument ID
+   * @return number of conflated quotes
+   */
+  [[nodiscard]] uint64_t get_conflated_quote_count(const std::string &exchange_id,
+                                                   const std::string &instrument_id) const;
+
+  /**
+   * Call to deliver market data in batches.
+   * Quotes, entrusts and transactions read in a row are collected into one MarketDataBatch, in the order they were
+   * read from the journal across all three types, and delivered to on_market_data, which by default passes each run
+   * of the same type to on_quotes, on_entrusts or on_transactions in that same order.
+   * A batch is delivered at the end of each drain cycle, once it holds 1024 items, and right before any other event,
+   * e.g. an order, trade, order action error, tree or custom data, which are always delivered one by one. Strategies
+   * therefore never see any event ahead of market data that preceded it in the journal.
+   */
+  void batch_market_data();
+
+  /**
+   * Tells whether market data is delivered in batches.
+   * @return true if batch_market_data is called. Defaults to false.
+   */
+  [[nodiscard]] bool is_market_data_batched() const;
+
   /**
    * request deregister.
    * @return void
@@ -248,6 +292,11 @@ private:
   bool book_held_ = false;
   bool positions_mirrored_ = true;
   bool bypass_accounting_ = false;
+  int64_t quote_conflation_threshold_ = 0;
+  bool market_data_batched_ = false;
+  std::unordered_map<uint32_t, uint64_t> conflated_quote_counts_ = {};
+
+  friend class Runner;
 };
 } // namespace kungfu::wingchun::strategy
 
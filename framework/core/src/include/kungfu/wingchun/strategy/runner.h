@@ -47,6 +47,9 @@ protected:
   virtual void post_stop();
 
 private:
+  static constexpr size_t QUOTE_CONFLATION_WINDOW_COUNT = 4096;
+  static constexpr size_t MARKET_DATA_BATCH_LIMIT = 1024;
+
   bool positions_requested_ = false;
   bool broker_states_requested_ = false;
   bool positions_set_;
@@ -54,9 +57,28 @@ private:
   std::vector<Strategy_ptr> strategies_ = {};
   RuntimeContext_ptr context_;
   const std::string arguments_;
+  std::vector<std::pair<longfist::types::Quote, uint32_t>> conflated_quotes_ = {};
+  std::unordered_map<uint32_t, size_t> conflated_quote_slots_ = {};
+  int64_t conflation_window_start_ = 0;
+  size_t conflation_window_count_ = 0;
+  MarketDataBatch market_data_batch_ = {};
 
   void prepare(const event_ptr &event);
   void inspect_channel(const event_ptr &event);
+  void on_quote(const event_ptr &event);
+  void flush_conflated_quotes();
+  void flush_batches();
+
+  template <typename DataType, typename OnMethod> void deliver(OnMethod method, const DataType &data, uint32_t source) {
+    if (context_->is_market_data_batched()) {
+      market_data_batch_.push_back(data, get_location(source));
+      if (market_data_batch_.size() >= MARKET_DATA_BATCH_LIMIT) {
+        flush_batches();
+      }
+      return;
+    }
+    invoke(method, data, get_location(source));
+  }
 
   template <typename OnMethod = void (Strategy::*)(Context_ptr &)> void invoke(OnMethod method) {
     auto context = std::dynamic_pointer_cast<Context>(context_);
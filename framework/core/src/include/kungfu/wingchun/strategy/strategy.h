@@ -13,6 +13,130 @@
 namespace kungfu::wingchun::strategy {
 FORWARD_DECLARE_CLASS_PTR(Context)
 
+/**
+ * Read only view of market data of one type, in journal order.
+ * It is only valid inside the callback it is passed to.
+ */
+template <typename DataType> class Batch {
+public:
+  Batch(const DataType *data, const kungfu::yijinjing::data::location_ptr *locations, size_t size)
+      : data_(data), locations_(locations), size_(size) {}
+
+  [[nodiscard]] size_t size() const { return size_; }
+
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  [[nodiscard]] const DataType &operator[](size_t index) const { return data_[index]; }
+
+  [[nodiscard]] const kungfu::yijinjing::data::location_ptr &location(size_t index) const { return locations_[index]; }
+
+  [[nodiscard]] const DataType *begin() const { return data_; }
+
+  [[nodiscard]] const DataType *end() const { return data_ + size_; }
+
+private:
+  const DataType *data_;
+  const kungfu::yijinjing::data::location_ptr *locations_;
+  size_t size_;
+};
+
+/**
+ * Quotes, entrusts and transactions collected by runner within one drain cycle, in journal order across all types.
+ * Each type is stored contiguously, so that a run of items of the same type is available as one Batch view.
+ * It is only valid inside the callback it is passed to.
+ */
+class MarketDataBatch {
+public:
+  [[nodiscard]] size_t size() const { return sequence_.size(); }
+
+  [[nodiscard]] bool empty() const { return sequence_.empty(); }
+
+  /**
+   * @return Quote::tag, Entrust::tag or Transaction::tag of the item at index in journal order
+   */
+  [[nodiscard]] int32_t msg_type(size_t index) const { return sequence_[index].first; }
+
+  /**
+   * @return the item at index in journal order, which must be of DataType
+   */
+  template <typename DataType> [[nodiscard]] const DataType &data(size_t index) const {
+    return store<DataType>().data[sequence_[index].second];
+  }
+
+  [[nodiscard]] const kungfu::yijinjing::data::location_ptr &location(size_t index) const {
+    switch (msg_type(index)) {
+    case longfist::types::Quote::tag:
+      return quotes_.locations[sequence_[index].second];
+    case longfist::types::Entrust::tag:
+      return entrusts_.locations[sequence_[index].second];
+    default:
+      return transactions_.locations[sequence_[index].second];
+    }
+  }
+
+  /**
+   * @return all items of DataType, in journal order among themselves
+   */
+  template <typename DataType> [[nodiscard]] Batch<DataType> all() const {
+    const auto &typed = store<DataType>();
+    return {typed.data.data(), typed.locations.data(), typed.data.size()};
+  }
+
+  /**
+   * @return items in [begin, end) of journal order, which must all be of DataType
+   */
+  template <typename DataType> [[nodiscard]] Batch<DataType> slice(size_t begin, size_t end) const {
+    const auto &typed = store<DataType>();
+    auto offset = begin < end ? sequence_[begin].second : 0;
+    return {typed.data.data() + offset, typed.locations.data() + offset, end - begin};
+  }
+
+  template <typename DataType>
+  void push_back(const DataType &data, const kungfu::yijinjing::data::location_ptr &location) {
+    auto &typed = store<DataType>();
+    sequence_.emplace_back(DataType::tag, typed.data.size());
+    typed.data.push_back(data);
+    typed.locations.push_back(location);
+  }
+
+  void clear() {
+    sequence_.clear();
+    quotes_.clear();
+    entrusts_.clear();
+    transactions_.clear();
+  }
+
+private:
+  template <typename DataType> struct typed_store {
+    std::vector<DataType> data = {};
+    std::vector<kungfu::yijinjing::data::location_ptr> locations = {};
+
+    void clear() {
+      data.clear();
+      locations.clear();
+    }
+  };
+
+  std::vector<std::pair<int32_t, size_t>> sequence_ = {};
+  typed_store<longfist::types::Quote> quotes_ = {};
+  typed_store<longfist::types::Entrust> entrusts_ = {};
+  typed_store<longfist::types::Transaction> transactions_ = {};
+
+  template <typename DataType> [[nodiscard]] const typed_store<DataType> &store() const {
+    if constexpr (std::is_same_v<DataType, longfist::types::Quote>) {
+      return quotes_;
+    } else if constexpr (std::is_same_v<DataType, longfist::types::Entrust>) {
+      return entrusts_;
+    } else {
+      return transactions_;
+    }
+  }
+
+  template <typename DataType> [[nodiscard]] typed_store<DataType> &store() {
+    return const_cast<typed_store<DataType> &>(std::as_const(*this).store<DataType>());
+  }
+};
+
 class Strategy {
 public:
   virtual ~Strategy() = default;
@@ -61,6 +185,56 @@ public:
   virtual void on_transaction(Context_ptr &context, const longfist::types::Transaction &transaction,
                               const kungfu::yijinjing::data::location_ptr &location){};
 
+  // 批量行情回调, 调用 context->batch_market_data() 开启后, 行情, 逐笔委托和逐笔成交按日志顺序在此成批送达
+  // 默认按日志顺序将连续的同类数据分段转发到 on_quotes, on_entrusts 和 on_transactions
+  // @param batch             行情数据及其来源, 仅在回调内有效
+  virtual void on_market_data(Context_ptr &context, const MarketDataBatch &batch) {
+    size_t begin = 0;
+    while (begin < batch.size()) {
+      auto msg_type = batch.msg_type(begin);
+      auto end = begin + 1;
+      while (end < batch.size() and batch.msg_type(end) == msg_type) {
+        end++;
+      }
+      switch (msg_type) {
+      case longfist::types::Quote::tag:
+        on_quotes(context, batch.slice<longfist::types::Quote>(begin, end));
+        break;
+      case longfist::types::Entrust::tag:
+        on_entrusts(context, batch.slice<longfist::types::Entrust>(begin, end));
+        break;
+      default:
+        on_transactions(context, batch.slice<longfist::types::Transaction>(begin, end));
+      }
+      begin = end;
+    }
+  }
+
+  // 批量行情数据回调, 由 on_market_data 默认实现按连续的一段行情调用, 默认逐条转发到 on_quote
+  // @param quotes            行情数据及其来源, 仅在回调内有效
+  virtual void on_quotes(Context_ptr &context, const Batch<longfist::types::Quote> &quotes) {
+    for (size_t i = 0; i < quotes.size(); i++) {
+      on_quote(context, quotes[i], quotes.location(i));
+    }
+  }
+
+  // 批量逐笔委托回调, 由 on_market_data 默认实现按连续的一段逐笔委托调用, 默认逐条转发到 on_entrust
+  // @param entrusts          逐笔委托数据及其来源, 仅在回调内有效
+  virtual void on_entrusts(Context_ptr &context, const Batch<longfist::types::Entrust> &entrusts) {
+    for (size_t i = 0; i < entrusts.size(); i++) {
+      on_entrust(context, entrusts[i], entrusts.location(i));
+    }
+  }
+
+  // 批量逐笔成交回调, 由 on_market_data 默认实现按连续的一段逐笔成交调用, 默认逐条转发到 on_transaction
+  // @param transactions      逐笔成交数据及其来源, 仅在回调内有效
+  virtual void on_transactions(Context_ptr &context,
+                               const Batch<longfist::types::Transaction> &transactions) {
+    for (size_t i = 0; i < transactions.size(); i++) {
+      on_transaction(context, transactions[i], transactions.location(i));
+    }
+  }
+
   // 订单信息更新回调
   // @param order             订单信息数据
   // @param location          数据来源
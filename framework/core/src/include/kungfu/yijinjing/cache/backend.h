@@ -69,23 +69,85 @@ using ProfileStoragePtr = decltype(make_storage_ptr(std::string(), longfist::Pro
 using SessionStoragePtr = decltype(make_storage_ptr(std::string(), longfist::SessionDataTypes));
 using StateStoragePtr = decltype(make_storage_ptr(std::string(), longfist::StateDataTypes));
 
+/**
+ * Creates an index on the timestamp column of each table, so that time range queries do not scan whole tables.
+ * Called once by the writer of the storage right after creating its tables, readers never change the schema.
+ * Failures are ignored since the index is only an optimization.
+ */
+template <typename StoragePtr, typename DataTypes> void index_timestamps(StoragePtr &storage, const DataTypes &types) {
+  std::vector<std::string> statements = {};
+  boost::hana::for_each(types, [&](auto it) {
+    using DataType = typename decltype(+boost::hana::second(it))::type;
+    if constexpr (DataType::has_timestamp) {
+      statements.push_back(fmt::format("CREATE INDEX IF NOT EXISTS idx_{0}_{1} ON {0}({1})",
+                                       DataType::type_name.c_str(), DataType::timestamp_key.value().c_str()));
+    }
+  });
+  storage->on_open = [&statements](sqlite3 *db) {
+    for (const auto &statement : statements) {
+      sqlite3_exec(db, statement.c_str(), nullptr, nullptr, nullptr);
+    }
+  };
+  storage->pragma.user_version(); // opens a connection once, which runs the statements above
+  storage->on_open = nullptr;
+}
+
 template <typename, typename = void, bool = true> struct time_spec;
 
 template <typename DataType> struct time_spec<DataType, std::enable_if_t<not DataType::has_timestamp>> {
   static std::vector<DataType> get_all(StateStoragePtr &storage, int64_t, int64_t) {
     return storage->get_all<DataType>();
   };
+
+  /**
+   * Rows ordered by primary key, skipping the first skip rows, so that pages stay stable across queries.
+   */
+  static std::vector<DataType> get_page(StateStoragePtr &storage, int64_t, int64_t, uint32_t skip, uint32_t limit) {
+    return storage->get_all<DataType>(primary_key_order(), sqlite_orm::limit(limit, sqlite_orm::offset(skip)));
+  };
+
+  static int64_t get_time(const DataType &) { return 0; }
+
+private:
+  static auto primary_key_order() {
+    auto data_accessors = boost::hana::accessors<DataType>();
+    auto orders = boost::hana::transform(DataType::primary_keys, [&](auto pk) {
+      auto pk_member = boost::hana::find_if(data_accessors, hana::on(boost::hana::equal.to(pk), boost::hana::first));
+      [[maybe_unused]] auto accessor = boost::hana::second(*pk_member);
+      return sqlite_orm::order_by(member_pointer_trait<decltype(accessor)>().pointer());
+    });
+    return boost::hana::unpack(orders, [](auto... orders) { return sqlite_orm::multi_order_by(std::move(orders)...); });
+  }
 };
 
 template <typename DataType> struct time_spec<DataType, std::enable_if_t<DataType::has_timestamp>> {
   static std::vector<DataType> get_all(StateStoragePtr &storage, int64_t from, int64_t to) {
-    auto comparator = [](auto it) { return DataType::timestamp_key.value() == boost::hana::first(it); };
-    auto just = boost::hana::find_if(boost::hana::accessors<DataType>(), comparator);
-    [[maybe_unused]] auto accessor = boost::hana::second(*just);
-    auto ts = member_pointer_trait<decltype(accessor)>().pointer();
+    auto ts = timestamp_pointer();
     return storage->get_all<DataType>(sqlite_orm::where(
         sqlite_orm::and_(sqlite_orm::greater_or_equal(ts, from), sqlite_orm::lesser_or_equal(ts, to))));
   };
+
+  /**
+   * Rows ordered by timestamp within [from, to], skipping the first skip rows, served by the timestamp index.
+   */
+  static std::vector<DataType> get_page(StateStoragePtr &storage, int64_t from, int64_t to, uint32_t skip,
+                                        uint32_t limit) {
+    auto ts = timestamp_pointer();
+    return storage->get_all<DataType>(
+        sqlite_orm::where(
+            sqlite_orm::and_(sqlite_orm::greater_or_equal(ts, from), sqlite_orm::lesser_or_equal(ts, to))),
+        sqlite_orm::order_by(ts), sqlite_orm::limit(limit, sqlite_orm::offset(skip)));
+  };
+
+  static int64_t get_time(const DataType &data) { return data.*timestamp_pointer(); }
+
+private:
+  static auto timestamp_pointer() {
+    auto comparator = [](auto it) { return DataType::timestamp_key.value() == boost::hana::first(it); };
+    auto just = boost::hana::find_if(boost::hana::accessors<DataType>(), comparator);
+    [[maybe_unused]] auto accessor = boost::hana::second(*just);
+    return member_pointer_trait<decltype(accessor)>().pointer();
+  }
 };
 
 class shift {
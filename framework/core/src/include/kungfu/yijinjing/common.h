@@ -10,15 +10,26 @@
 
 #include <kungfu/common.h>
 #include <kungfu/longfist/longfist.h>
+#include <kungfu/yijinjing/util/os.h>
 #include <kungfu/yijinjing/util/stacktrace.h>
 #include <kungfu/yijinjing/util/util.h>
 #include <nng/compat/nanomsg/nn.h>
 
+#define JOURNAL_PAGE_SIZE_ENV "KF_JOURNAL_PAGE_SIZE"
+#define JOURNAL_PAGE_RECYCLE_ENV "KF_JOURNAL_PAGE_RECYCLE"
+#define PROFILE_DISPATCH_ENV "KF_PROFILE_DISPATCH"
+#define CPU_AFFINITY_ENV "KF_CPU_AFFINITY"
+#define AUX_CPU_AFFINITY_ENV "KF_AUX_CPU_AFFINITY"
+#define RT_PRIORITY_ENV "KF_RT_PRIORITY"
+#define MLOCK_ENV "KF_MLOCK"
+
 namespace kungfu {
 namespace yijinjing {
 /** size related */
 constexpr int KB = 1024;
 constexpr int MB = KB * KB;
+constexpr uint32_t MIN_PAGE_SIZE = 64 * KB;
+constexpr uint32_t MAX_PAGE_SIZE = 2048u * MB;
 
 class yijinjing_error : public std::runtime_error {
 public:
@@ -91,6 +102,16 @@ public:
 
   [[nodiscard]] virtual std::vector<uint32_t> list_location_dest_by_db(const location_ptr &location) const;
 
+  /**
+   * Size of new journal pages for given location and dest. Rules in env KF_JOURNAL_PAGE_SIZE take precedence, e.g.
+   * "md=256M,td/sim=32M,system/master=256K", the most specific matched category[/group[/name[/mode]]] wins, and any
+   * component can be a wildcard "*".
+   * Pages that already exist keep the size recorded in their header. Only writers call this for new pages, readers
+   * wait for the header, so processes with different env still map each page at the same size.
+   * @return page size in bytes
+   */
+  [[nodiscard]] virtual uint32_t get_page_size(const location_ptr &location, uint32_t dest_id) const;
+
   bool operator==(const locator &another) const;
 
 private:
@@ -175,6 +196,18 @@ static constexpr auto error_handler_log = [](const std::string &subscriber_name)
   };
 };
 
+/**
+ * Same as observe_on_new_thread, except that the new threads are pinned to the auxiliary cpus of the process, if any.
+ */
+[[maybe_unused]] static constexpr auto observe_on_aux_thread = []() {
+  return observe_on_one_worker(schedulers::make_new_thread([](std::function<void()> start) {
+    return std::thread([start = std::move(start)]() {
+      yijinjing::os::place_aux_thread();
+      start();
+    });
+  }));
+};
+
 [[maybe_unused]] static constexpr auto complete_handler_log = [](const std::string &subscriber_name) {
   return [=]() { SPDLOG_DEBUG("subscriber {} completed", subscriber_name); };
 };
@@ -49,7 +49,14 @@ public:
 
   void update_session(const journal::frame_ptr &frame);
 
-  [[maybe_unused]] void rebuild_index_db();
+  /**
+   * Rebuild session rows from journals of master, one worker thread per journal location.
+   * Each (location, dest) journal records its last indexed page and frame time in SessionIndex, an incremental
+   * rebuild only scans frames written after that.
+   * @param incremental resume from the last indexed frames, otherwise drop all sessions and scan from start
+   * @param thread_count number of worker threads, 0 for hardware concurrency
+   */
+  [[maybe_unused]] void rebuild_index_db(bool incremental = true, uint32_t thread_count = 0);
 
 private:
   SessionMap live_sessions_ = {};
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef YIJINJING_COLUMNAR_H
+#define YIJINJING_COLUMNAR_H
+
+#include <kungfu/longfist/longfist.h>
+#include <kungfu/yijinjing/journal/assemble.h>
+
+namespace kungfu::yijinjing::journal {
+template <typename ValueType> std::string numpy_dtype() {
+  if constexpr (std::is_enum_v<ValueType>) {
+    return numpy_dtype<std::underlying_type_t<ValueType>>();
+  } else if constexpr (std::is_same_v<ValueType, bool>) {
+    return "|b1";
+  } else if constexpr (std::is_floating_point_v<ValueType>) {
+    return fmt::format("<f{}", sizeof(ValueType));
+  } else if constexpr (sizeof(ValueType) == 1) {
+    return std::is_signed_v<ValueType> ? "|i1" : "|u1";
+  } else {
+    return fmt::format("<{}{}", std::is_signed_v<ValueType> ? "i" : "u", sizeof(ValueType));
+  }
+}
+
+/**
+ * Numpy dtype and length of a longfist field, char arrays map to byte strings, other arrays to sub arrays.
+ */
+template <typename AttrType> std::pair<std::string, size_t> numpy_field_dtype() {
+  if constexpr (is_array_of_v<AttrType, char>) {
+    return {fmt::format("|S{}", AttrType::length), 1};
+  } else if constexpr (is_array_v<AttrType>) {
+    return {numpy_dtype<typename AttrType::element_type>(), AttrType::length};
+  } else {
+    return {numpy_dtype<AttrType>(), 1};
+  }
+}
+
+/**
+ * Writes frames of size fixed longfist types into columnar files, one contiguous array per field.
+ * Layout is {output_dir}/{type_name}/{field}.bin, plus gen_time.bin for frame time and schema.json that describes
+ * numpy dtype and shape of each column.
+ */
+class columnar_sink : public sink {
+public:
+  columnar_sink(std::string output_dir, const std::vector<std::string> &type_names, int64_t begin_time = 0,
+                int64_t end_time = INT64_MAX, const std::vector<std::string> &instrument_ids = {});
+
+  ~columnar_sink() override;
+
+  void put(const data::location_ptr &location, uint32_t dest_id, const frame_ptr &frame) override;
+
+  void close() override;
+
+  [[nodiscard]] int64_t get_rows() const;
+
+private:
+  struct column {
+    std::string name;
+    std::string dtype;
+    size_t length;
+    size_t offset;
+    size_t size;
+    FILE *file;
+  };
+
+  struct table {
+    std::string type_name;
+    size_t instrument_id_offset;
+    size_t instrument_id_size;
+    int64_t rows;
+    std::vector<column> columns;
+  };
+
+  std::string output_dir_;
+  int64_t begin_time_;
+  int64_t end_time_;
+  std::unordered_set<std::string> instrument_ids_;
+  std::unordered_map<int32_t, table> tables_ = {};
+
+  void open_table(table &t);
+
+  void write_schema(const table &t) const;
+};
+DECLARE_PTR(columnar_sink)
+
+/**
+ * Export journals of matched locations into columnar files, each location is exported by one worker thread into
+ * {output_dir}/{category}/{group}/{name}/{mode}.
+ * @return number of exported rows
+ */
+[[maybe_unused]] int64_t export_columnar(const data::locator_ptr &locator, const std::string &output_dir,
+                                         const std::vector<std::string> &type_names, int64_t begin_time = 0,
+                                         int64_t end_time = INT64_MAX,
+                                         const std::vector<std::string> &instrument_ids = {},
+                                         const std::string &mode = "*", const std::string &category = "*",
+                                         const std::string &group = "*", const std::string &name = "*",
+                                         uint32_t thread_count = 0);
+} // namespace kungfu::yijinjing::journal
+#endif // YIJINJING_COLUMNAR_H
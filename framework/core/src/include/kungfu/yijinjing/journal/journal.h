@@ -46,6 +46,13 @@ public:
    */
   void seek_to_time(int64_t nanotime);
 
+  /**
+   * makes sure after this call, current_frame() gets the first frame after nanotime, searching from given page on
+   * @param page_id id of the page to start from
+   * @param nanotime
+   */
+  void seek_to_page(uint32_t page_id, int64_t nanotime);
+
 private:
   const data::location_ptr location_;
   const uint32_t dest_id_;
@@ -54,9 +61,20 @@ private:
   page_ptr page_;
   frame_ptr frame_;
   uint64_t page_frame_nb_;
+  uint32_t pending_page_id_ = 0;
+  int64_t pending_check_time_ = 0;
 
+  /**
+   * Loads the page, or for a reader, if its writer has not initialized it yet, points the current frame to an empty
+   * one and keeps the page pending, to be loaded by load_pending_page once initialized.
+   */
   void load_page(int page_id);
 
+  /**
+   * Loads the pending page if its writer has initialized it, checks at most once per millisecond.
+   */
+  void load_pending_page(int64_t nanotime);
+
   /** load next page, current page will be released if not empty */
   void load_next_page();
 
@@ -79,6 +97,15 @@ public:
    */
   void join(const data::location_ptr &location, uint32_t dest_id, int64_t from_time);
 
+  /**
+   * join journal at given data location, strictly after a frame read before
+   * @param location where the journal locates
+   * @param dest_id journal dest id
+   * @param page_id id of the page that holds the frame read before, or 0 if unknown
+   * @param frame_time gen time of the frame read before
+   */
+  void resume(const data::location_ptr &location, uint32_t dest_id, uint32_t page_id, int64_t frame_time);
+
   void disjoin(uint32_t location_uid);
 
   void disjoin_channel(uint32_t location_uid, uint32_t dest_id);
@@ -129,7 +156,7 @@ public:
 
   [[maybe_unused]] void mark_at(int64_t gen_time, int64_t trigger_time, int32_t msg_type);
 
-  [[maybe_unused]] void write_raw(int64_t trigger_time, int32_t msg_type, uintptr_t data, uint32_t length);
+  void write_raw(int64_t trigger_time, int32_t msg_type, uintptr_t data, uint32_t length);
 
   [[maybe_unused]] void write_bytes(int64_t trigger_time, int32_t msg_type, const std::vector<uint8_t> &data,
                                     uint32_t length);
@@ -157,7 +184,7 @@ public:
 
   template <typename T>
   std::enable_if_t<size_unfixed_v<T>> write(int64_t trigger_time, const T &data, int32_t msg_type = T::tag) {
-    auto s = data.to_string();
+    auto s = data.to_bytes();
     auto size = s.length();
     auto frame = open_frame(trigger_time, msg_type, size);
     memcpy(const_cast<void *>(frame->data_address()), s.c_str(), size);
@@ -175,7 +202,7 @@ public:
 
   template <typename T>
   std::enable_if_t<size_unfixed_v<T>> write_as(int64_t trigger_time, const T &data, uint32_t source, uint32_t dest) {
-    auto s = data.to_string();
+    auto s = data.to_bytes();
     auto size = s.length();
     auto frame = open_frame(trigger_time, T::tag, size);
     memcpy(const_cast<void *>(frame->data_address()), s.c_str(), size);
@@ -193,7 +220,7 @@ public:
 
   template <typename T>
   [[maybe_unused]] std::enable_if_t<size_unfixed_v<T>> write_at(int64_t gen_time, int64_t trigger_time, const T &data) {
-    auto s = data.to_string();
+    auto s = data.to_bytes();
     auto size = s.length();
     auto frame = open_frame(trigger_time, T::tag, size);
     memcpy(const_cast<void *>(frame->data_address()), s.c_str(), size);
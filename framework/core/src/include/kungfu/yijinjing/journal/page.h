@@ -57,6 +57,11 @@ public:
 
   static std::string get_page_path(const data::location_ptr &location, uint32_t dest_id, uint32_t page_id);
 
+  /**
+   * Tells whether the page exists with a header initialized by its writer, so that its size is known to readers.
+   */
+  static bool is_initialized(const data::location_ptr &location, uint32_t dest_id, uint32_t page_id);
+
   static uint32_t find_page_id(const data::location_ptr &location, uint32_t dest_id, int64_t time);
 
 private:
@@ -82,15 +87,7 @@ private:
 };
 
 inline static uint32_t find_page_size(const data::location_ptr &location, uint32_t dest_id) {
-  if (location->category == longfist::enums::category::MD && dest_id != 1) {
-    return 128 * MB;
-  }
-  if ((location->category == longfist::enums::category::TD ||
-       location->category == longfist::enums::category::STRATEGY) &&
-      dest_id != 0) {
-    return 16 * MB;
-  }
-  return MB;
+  return location->locator->get_page_size(location, dest_id);
 }
 } // namespace kungfu::yijinjing::journal
 
@@ -10,13 +10,85 @@
 #include <kungfu/common.h>
 #include <kungfu/yijinjing/common.h>
 
+#include <atomic>
+#include <thread>
+
 #define LOG_LEVEL_ENV "KF_LOG_LEVEL"
+#define LOG_ASYNC_QUEUE_ENV "KF_LOG_ASYNC_QUEUE"
+#define LOG_OVERFLOW_ENV "KF_LOG_OVERFLOW"
 #define DEFAULT_LOG_LEVEL_NAME "info"
 #define TS_PATTERN "[%m/%d %H:%M:%S.%N] "
+#define TS_SECOND_PATTERN "[%m/%d %H:%M:%S."
 #define LOG_PATTERN "[%^%=8l%$] [%6P/%-6t] [%s:%##%!] %v"
 
 namespace kungfu::yijinjing::log {
 
+enum class overflow_policy : int8_t {
+  block, // calling thread spins until the queue has room
+  drop,  // message is discarded and counted
+};
+
+/**
+ * Sink that hands messages over to a background thread through a preallocated lock-free ring, the background thread
+ * writes to the wrapped sinks and flushes them whenever the ring drains.
+ * Messages dropped on overflow are reported as a warning to the wrapped sinks every few seconds and at shutdown.
+ */
+class async_sink : public spdlog::sinks::sink {
+public:
+  async_sink(std::vector<spdlog::sink_ptr> sinks, size_t queue_size, overflow_policy policy = overflow_policy::block);
+
+  ~async_sink() override;
+
+  void log(const spdlog::details::log_msg &msg) override;
+
+  void flush() override;
+
+  void set_pattern(const std::string &pattern) override;
+
+  void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+  [[nodiscard]] uint64_t get_dropped_count() const;
+
+private:
+  struct slot {
+    std::atomic<size_t> sequence;
+    spdlog::level::level_enum level;
+    spdlog::log_clock::time_point time;
+    size_t thread_id;
+    int line;
+    std::string logger_name;
+    std::string filename;
+    std::string funcname;
+    std::string payload;
+  };
+
+  std::vector<spdlog::sink_ptr> sinks_;
+  const overflow_policy policy_;
+  const size_t mask_;
+  std::unique_ptr<slot[]> slots_;
+  alignas(64) std::atomic<size_t> enqueue_pos_ = 0;
+  alignas(64) std::atomic<size_t> dequeue_pos_ = 0;
+  std::atomic<uint64_t> dropped_ = 0;
+  uint64_t reported_dropped_ = 0;
+  std::atomic<bool> running_ = true;
+  std::thread worker_;
+
+  bool try_push(const spdlog::details::log_msg &msg);
+
+  bool try_pop();
+
+  void report_dropped();
+
+  void drain();
+};
+
+overflow_policy get_env_log_overflow_policy(const data::locator_ptr &locator);
+
+/**
+ * @return queue size of async log sink, 0 to log synchronously, also when the value is not a valid size
+ */
+size_t get_env_log_async_queue_size(const data::locator_ptr &locator);
+
 std::shared_ptr<spdlog::logger> get_main_logger();
 
 spdlog::level::level_enum get_env_log_level(const data::locator_ptr &locator);
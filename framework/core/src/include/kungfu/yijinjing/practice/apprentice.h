@@ -74,6 +74,8 @@ protected:
 
   virtual void on_start();
 
+  void on_bootstrap(const event_ptr &event);
+
   void on_register(int64_t trigger_time, const longfist::types::Register &register_data);
 
   void on_deregister(const event_ptr &event);
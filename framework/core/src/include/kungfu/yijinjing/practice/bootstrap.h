@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_YIJINJING_BOOTSTRAP_H
+#define KUNGFU_YIJINJING_BOOTSTRAP_H
+
+#include <kungfu/longfist/longfist.h>
+#include <kungfu/yijinjing/journal/journal.h>
+
+namespace kungfu::yijinjing::practice {
+/**
+ * Snapshot of the locations, registry, channels and bands known by master, which new apps need before they start.
+ * Master packs it once per change of that state and writes it to each app in a few Bootstrap frames, instead of
+ * writing one frame per record for every app. Apps unpack those frames into events of the original types, so
+ * subscribers see the same Location, Register, Channel and Band events as before.
+ * Records are msg_type, length and data as it would be in a frame, 8 bytes aligned, and never cross chunks.
+ */
+class bootstrap_snapshot {
+public:
+  /**
+   * Chunk size below the minimum journal page size, so that each chunk fits in one frame of any page.
+   */
+  static constexpr uint32_t CHUNK_SIZE = MIN_PAGE_SIZE / 2;
+
+  template <typename DataType> std::enable_if_t<size_fixed_v<DataType>> append(const DataType &data) {
+    append(DataType::tag, &data, sizeof(DataType));
+  }
+
+  template <typename DataType> std::enable_if_t<size_unfixed_v<DataType>> append(const DataType &data) {
+    auto bytes = data.to_bytes();
+    append(DataType::tag, bytes.data(), bytes.length());
+  }
+
+  void clear();
+
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * Writes all chunks, one Bootstrap frame each.
+   */
+  void write(int64_t trigger_time, const journal::writer_ptr &writer) const;
+
+  /**
+   * @param event Bootstrap frame written by master
+   * @return events of the records in the frame, carrying gen_time, trigger_time, source and dest of the frame
+   */
+  static std::vector<event_ptr> unpack(const event_ptr &event);
+
+private:
+  struct record_header {
+    int32_t msg_type;
+    uint32_t length;
+  };
+
+  std::vector<std::string> chunks_ = {};
+  size_t size_ = 0;
+
+  void append(int32_t msg_type, const void *data, uint32_t length);
+};
+} // namespace kungfu::yijinjing::practice
+
+#endif // KUNGFU_YIJINJING_BOOTSTRAP_H
@@ -12,7 +12,9 @@
 #include <kungfu/yijinjing/io.h>
 #include <kungfu/yijinjing/journal/journal.h>
 #include <kungfu/yijinjing/log.h>
+#include <kungfu/yijinjing/practice/profiler.h>
 #include <kungfu/yijinjing/time.h>
+#include <deque>
 
 #ifndef KUNGFU_SETUP_LOG
 #define KUNGFU_SETUP_LOG() kungfu::yijinjing::log::copy_log_settings(get_home(), get_home()->name)
@@ -125,6 +127,23 @@ public:
 
   const rx::connectable_observable<event_ptr> &get_events() const;
 
+  /**
+   * Asks for a dump of the dispatch profile at the next turn of the event loop, safe to call from signal handlers.
+   * @return false if dispatch profiling is not enabled
+   */
+  bool request_profile_dump();
+
+  /**
+   * @return effective thread placement in json, applied by run according to env KF_CPU_AFFINITY,
+   * KF_AUX_CPU_AFFINITY, KF_RT_PRIORITY and KF_MLOCK, empty if none is requested
+   */
+  [[nodiscard]] const std::string &get_thread_placement() const;
+
+  /**
+   * @return version of locations, registry, channels and bands, bumped on every change of them
+   */
+  [[nodiscard]] uint64_t get_registry_version() const;
+
 protected:
   int64_t begin_time_;
   int64_t end_time_;
@@ -176,6 +195,11 @@ protected:
   void require_write_to_band(int64_t trigger_time, uint32_t source_id,
                              const yijinjing::data::location_ptr &location) const;
 
+  /**
+   * Dispatches the event right after the one being dispatched, before the reader moves to the next frame.
+   */
+  void schedule_event(const event_ptr &event);
+
   virtual void react() = 0;
 
   virtual void on_active() = 0;
@@ -215,11 +239,23 @@ private:
   int64_t now_;
   volatile bool continual_ = true;
   volatile bool live_ = false;
+  dispatch_profiler_ptr profiler_ = {};
+  std::string thread_placement_ = {};
+  uint64_t registry_version_ = 0;
+  std::deque<event_ptr> scheduled_events_ = {};
 
   void produce(const rx::subscriber<event_ptr> &sb);
 
   bool drain(const rx::subscriber<event_ptr> &sb);
 
+  void dispatch_profiled(const rx::subscriber<event_ptr> &sb);
+
+  void dispatch_scheduled(const rx::subscriber<event_ptr> &sb);
+
+  void dump_profile();
+
+  void place_threads();
+
   template <typename T>
   std::enable_if_t<T::reflect> do_require_read_from(yijinjing::journal::writer_ptr &&writer, int64_t trigger_time,
                                                     uint32_t dest_id, uint32_t source_id, int64_t from_time) {
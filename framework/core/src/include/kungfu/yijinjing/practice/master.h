@@ -9,6 +9,7 @@
 
 #include <kungfu/yijinjing/io.h>
 #include <kungfu/yijinjing/journal/common.h>
+#include <kungfu/yijinjing/practice/bootstrap.h>
 #include <kungfu/yijinjing/practice/hero.h>
 #include <kungfu/yijinjing/practice/profile.h>
 
@@ -62,6 +63,10 @@ private:
 
   std::unordered_map<uint32_t, uint32_t> app_cmd_locations_ = {};
   std::unordered_map<uint32_t, std::unordered_map<int32_t, timer_task>> timer_tasks_ = {};
+  bootstrap_snapshot register_bootstrap_ = {};
+  bootstrap_snapshot start_bootstrap_ = {};
+  uint64_t register_bootstrap_version_ = UINT64_MAX;
+  uint64_t start_bootstrap_version_ = UINT64_MAX;
 
   void handle_timer_tasks();
 
@@ -95,13 +100,17 @@ private:
 
   void write_trading_day(int64_t trigger_time, const journal::writer_ptr &writer);
 
-  void write_locations(int64_t trigger_time, const journal::writer_ptr &writer);
+  /**
+   * Packs locations and registries into register_bootstrap_, if any of them changed since last time.
+   */
+  void update_register_bootstrap();
 
-  void write_registries(int64_t trigger_time, const journal::writer_ptr &writer);
+  /**
+   * Packs locations, registries, channels and bands into start_bootstrap_, if any of them changed since last time.
+   */
+  void update_start_bootstrap();
 
-  void write_channels(int64_t trigger_time, const journal::writer_ptr &writer);
-
-  void write_bands(int64_t trigger_time, const journal::writer_ptr &writer);
+  void append_registry(bootstrap_snapshot &bootstrap) const;
 };
 } // namespace kungfu::yijinjing::practice
 #endif // KUNGFU_MASTER_H
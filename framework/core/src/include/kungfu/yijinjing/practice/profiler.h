@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_YIJINJING_PROFILER_H
+#define KUNGFU_YIJINJING_PROFILER_H
+
+#include <kungfu/yijinjing/common.h>
+#include <kungfu/yijinjing/util/histogram.h>
+
+namespace kungfu::yijinjing::practice {
+FORWARD_DECLARE_CLASS_PTR(dispatch_profiler)
+
+/**
+ * Dispatch profiler of hero, attributes the wall time spent by all subscribers of each msg_type, and the reader lag
+ * (dispatch time minus frame gen_time) of frames of that type.
+ * Enabled by env KF_PROFILE_DISPATCH, "on"/"true" dumps every 60 seconds, a number sets the interval in seconds.
+ * Each dump is written to log and starts a new window, a dump can also be requested at any time, e.g. by SIGUSR2.
+ */
+class dispatch_profiler {
+public:
+  /**
+   * @return profiler configured by env of locator, nullptr if profiling is not enabled
+   */
+  static dispatch_profiler_ptr from_env(const data::locator_ptr &locator);
+
+  explicit dispatch_profiler(int64_t interval);
+
+  void record(int32_t msg_type, int64_t lag, int64_t duration) {
+    auto &entry = entries_[msg_type];
+    entry.lag.record(lag);
+    entry.duration.record(duration);
+  }
+
+  [[nodiscard]] bool is_due(int64_t nanotime) const { return dump_requested_ or nanotime >= next_dump_time_; }
+
+  void request_dump() { dump_requested_ = true; }
+
+  void dump(int64_t nanotime, const std::string &uname);
+
+private:
+  struct entry {
+    util::histogram lag;
+    util::histogram duration;
+  };
+
+  const int64_t interval_;
+  int64_t window_start_;
+  int64_t next_dump_time_;
+  volatile bool dump_requested_ = false;
+  std::unordered_map<int32_t, entry> entries_ = {};
+};
+} // namespace kungfu::yijinjing::practice
+
+#endif // KUNGFU_YIJINJING_PROFILER_H
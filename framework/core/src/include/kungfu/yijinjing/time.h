@@ -12,6 +12,8 @@
 #define KUNGFU_TRADING_DAY_FORMAT "%Y%m%d"
 #define KUNGFU_HISTORY_DAY_FORMAT "%Y-%m-%d"
 
+#define CLOCK_SOURCE_ENV "KF_CLOCK_SOURCE"
+
 namespace kungfu::yijinjing {
 struct time_unit {
   static constexpr int64_t MILLISECONDS_PER_SECOND = 1000;
@@ -32,6 +34,12 @@ struct time_unit {
   static constexpr int64_t UTC_OFFSET = NANOSECONDS_PER_HOUR * 8;
 };
 
+/**
+ * Clock that drives time::now_in_nano, steady reads clock_gettime(CLOCK_MONOTONIC), tsc reads the invariant time stamp
+ * counter and converts cycles to steady nano seconds with a calibrated ratio.
+ */
+enum class clock_source { steady, tsc };
+
 struct time_point_info {
   int64_t system_clock_count;
   int64_t steady_clock_count;
@@ -119,6 +127,26 @@ public:
    */
   static void reset(int64_t system_clock_count, int64_t steady_clock_count);
 
+  /**
+   * Select the clock behind now_in_nano, also picked up from env KF_CLOCK_SOURCE (steady|tsc) at startup.
+   * Falls back to steady if the cpu does not have an invariant tsc.
+   * @param source clock source to use
+   * @return true if the requested source is in use
+   */
+  static bool set_clock_source(clock_source source);
+
+  /**
+   * Clock source currently behind now_in_nano.
+   * @return clock source in use
+   */
+  static clock_source get_clock_source();
+
+  /**
+   * Whether the cpu has an invariant tsc that is usable as clock source.
+   * @return true if tsc clock source can be selected
+   */
+  static bool is_tsc_supported();
+
 private:
   time_point_info base_;
   time();
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KUNGFU_YIJINJING_HISTOGRAM_H
+#define KUNGFU_YIJINJING_HISTOGRAM_H
+
+#include <kungfu/common.h>
+
+namespace kungfu::yijinjing::util {
+/**
+ * Fixed memory histogram of non-negative values with log-linear buckets, in the manner of HdrHistogram.
+ * Values below 32 have a bucket each, every power of two above is split into 16 buckets, which bounds the relative
+ * error of a reported value by 1/16. Values from 2^36 (about 68 seconds in nanoseconds) on fall into the last bucket.
+ * Recording is a few arithmetic instructions and never allocates.
+ */
+class histogram {
+public:
+  static constexpr int SUB_BUCKET_BITS = 4;
+  static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+  static constexpr int MAX_EXPONENT = 35;
+  static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+
+  static size_t bucket_index(int64_t value) {
+    if (value < 2 * SUB_BUCKET_COUNT) {
+      return value < 0 ? 0 : value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    if (exponent > MAX_EXPONENT) {
+      return BUCKET_COUNT - 1;
+    }
+    auto sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub_bucket;
+  }
+
+  /** the highest value that falls into the bucket of given index */
+  static int64_t bucket_upper(size_t index) {
+    if (index < 2 * SUB_BUCKET_COUNT) {
+      return index;
+    }
+    int exponent = index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+    int64_t lower = int64_t(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << (exponent - SUB_BUCKET_BITS);
+    return lower + (int64_t(1) << (exponent - SUB_BUCKET_BITS)) - 1;
+  }
+
+  void record(int64_t value) {
+    buckets_[bucket_index(value)]++;
+    count_++;
+    sum_ += value;
+    min_ = count_ == 1 ? value : std::min(min_, value);
+    max_ = count_ == 1 ? value : std::max(max_, value);
+  }
+
+  /**
+   * Value at the given percentile, the upper bound of its bucket clamped by the recorded extremes.
+   * @param p percentile in [0, 1]
+   */
+  [[nodiscard]] int64_t percentile(double p) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    auto rank = std::max<int64_t>(1, std::ceil(p * count_));
+    int64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        return std::clamp(bucket_upper(i), min_, max_);
+      }
+    }
+    return max_;
+  }
+
+  void reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = 0;
+    max_ = 0;
+  }
+
+  [[nodiscard]] const std::array<uint32_t, BUCKET_COUNT> &buckets() const { return buckets_; }
+
+  [[nodiscard]] int64_t count() const { return count_; }
+
+  [[nodiscard]] int64_t min() const { return min_; }
+
+  [[nodiscard]] int64_t max() const { return max_; }
+
+  [[nodiscard]] double mean() const { return count_ == 0 ? 0 : double(sum_) / count_; }
+
+private:
+  std::array<uint32_t, BUCKET_COUNT> buckets_ = {};
+  int64_t count_ = 0;
+  int64_t sum_ = 0;
+  int64_t min_ = 0;
+  int64_t max_ = 0;
+};
+} // namespace kungfu::yijinjing::util
+
+#endif // KUNGFU_YIJINJING_HISTOGRAM_H
@@ -8,6 +8,7 @@
 #define KUNGFU_YIJINJING_OS_H
 
 #include <string>
+#include <vector>
 
 #ifdef _WINDOWS
 #define GETPID _getpid
@@ -25,11 +26,55 @@ namespace kungfu::yijinjing::os {
  */
 uintptr_t load_mmap_buffer(const std::string &path, size_t size, bool is_writing = false, bool lazy = true);
 
+/**
+ * create a file of given size and map it for writing, with every memory page of the buffer touched beforehand
+ * buffer memory is locked if not lazy
+ * @return the address of mapped memory, 0 if failed or not supported on this platform
+ */
+uintptr_t prefault_mmap_buffer(const std::string &path, size_t size, bool lazy = true);
+
 bool release_mmap_buffer(uintptr_t address, [[maybe_unused]] size_t size, bool lazy);
 
 [[maybe_unused]] void disable_os_signals_handler();
 
 void handle_os_signals(void *hero);
+
+/**
+ * Placement of the threads of this process.
+ * cpus pins the calling thread, normally the event loop, aux_cpus pins all other threads, including those started later
+ * by place_aux_thread, rt_priority (1-99) runs the calling thread with SCHED_FIFO, mlock locks memory of the process
+ * mapped so far, and journal pages mapped for writing later on by lock_placed_memory. Locking raises the soft
+ * RLIMIT_MEMLOCK to its hard limit, which must cover the locked memory (e.g. ulimit -l unlimited, or CAP_IPC_LOCK).
+ */
+struct thread_placement {
+  std::vector<int> cpus = {};
+  std::vector<int> aux_cpus = {};
+  int rt_priority = 0;
+  bool mlock = false;
+};
+
+/**
+ * parse cpu list in the format of taskset, e.g. "2", "2,3" or "2-5,8"
+ */
+std::vector<int> parse_cpu_list(const std::string &text);
+
+/**
+ * apply placement to this process, failures (e.g. lack of CAP_SYS_NICE) are logged and skipped
+ * only supported on linux
+ * @return effective placement in json, empty if nothing is requested
+ */
+std::string apply_thread_placement(const thread_placement &placement);
+
+/**
+ * pin the calling thread to the auxiliary cpus of the applied placement, does nothing if there is none
+ */
+void place_aux_thread();
+
+/**
+ * lock given memory if the applied placement locks memory
+ * failures (e.g. RLIMIT_MEMLOCK reached) are logged and skipped
+ */
+void lock_placed_memory(uintptr_t address, size_t size);
 } // namespace kungfu::yijinjing::os
 
 #endif // KUNGFU_YIJINJING_OS_H
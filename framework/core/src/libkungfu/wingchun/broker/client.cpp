@@ -117,6 +117,7 @@ void Client::renew(int64_t trigger_time, const location_ptr &md_location) {
       writer->write(trigger_time, instrument_key);
     }
   }
+  connect_bands(trigger_time, md_location);
 }
 
 bool Client::try_renew(int64_t trigger_time, const location_ptr &md_location) {
@@ -177,10 +178,46 @@ void Client::connect(const event_ptr &event, const Band &band) {
   auto source_id = band.source_id;
   auto dest_id = band.dest_id;
   auto source_location = app_.get_location(source_id);
-  SPDLOG_INFO("resume band from source {} {} to dest {} {}", source_id, app_.get_location_uname(source_id), dest_id,
-              app_.get_location_uname(dest_id));
-  if (source_location->category == category::MD and should_connect_md(source_location)) {
-    app_.request_read_from_source_to_dest(event->gen_time(), source_location, dest_id);
+  if (source_location->category != category::MD) {
+    return;
+  }
+  if (not app_.has_location(dest_id)) {
+    SPDLOG_WARN("band from source {} to unknown dest {:08x}, can not tell its shard, read it whole",
+                source_location->uname, dest_id);
+    if (should_connect_md(source_location)) {
+      app_.request_read_from_source_to_dest(event->gen_time(), source_location, dest_id);
+    }
+    return;
+  }
+  md_bands_[source_id].emplace(dest_id, app_.get_location(dest_id));
+  if (should_connect_md(source_location)) {
+    connect_bands(event->gen_time(), source_location);
+  }
+}
+
+bool Client::should_connect_band(const location_ptr &md_location, const location_ptr &band_location) const {
+  uint32_t shard = 0;
+  uint32_t shard_count = 0;
+  if (not parse_md_shard_name(band_location->name, shard, shard_count) or is_custom_subscribed(md_location->uid)) {
+    return true;
+  }
+  return std::any_of(instrument_keys_.begin(), instrument_keys_.end(), [&](const auto &pair) {
+    return get_md_shard(pair.second.exchange_id, pair.second.instrument_id, shard_count) == shard;
+  });
+}
+
+void Client::connect_bands(int64_t trigger_time, const location_ptr &md_location) {
+  if (md_bands_.find(md_location->uid) == md_bands_.end()) {
+    return;
+  }
+  for (const auto &pair : md_bands_.at(md_location->uid)) {
+    const auto &band_location = pair.second;
+    if (connected_bands_.find(band_location->uid) == connected_bands_.end() and
+        should_connect_band(md_location, band_location)) {
+      SPDLOG_INFO("resume band from source {} to dest {}", md_location->uname, band_location->uname);
+      app_.request_read_from_source_to_dest(trigger_time, md_location, band_location->uid);
+      connected_bands_.emplace(band_location->uid, band_location);
+    }
   }
 }
 
@@ -216,6 +253,11 @@ void Client::update_broker_state(const event_ptr &, const longfist::types::Dereg
   auto broker_location = app_.get_location(location_uid);
   broker_states_.emplace(location_uid, BrokerState::DisConnected);
   ready_md_locations_.erase(location_uid);
+  if (md_bands_.find(location_uid) != md_bands_.end()) {
+    for (const auto &pair : md_bands_.at(location_uid)) {
+      connected_bands_.erase(pair.first);
+    }
+  }
   ready_td_locations_.erase(location_uid);
 }
 
@@ -251,6 +293,10 @@ SilentAutoClient::SilentAutoClient(practice::apprentice &app) : AutoClient(app)
 //   return false;
 // }
 
+bool SilentAutoClient::should_connect_band(const location_ptr &md_location, const location_ptr &band_location) const {
+  return true;
+}
+
 void SilentAutoClient::renew(int64_t trigger_time, const location_ptr &md_location) {}
 
 void SilentAutoClient::sync(int64_t trigger_time, const location_ptr &td_location) {}
@@ -365,6 +411,7 @@ void PassiveClient::renew(int64_t trigger_time, const location_ptr &md_location)
       auto writer = app_.get_writer(md_location->uid);
       writer->write(trigger_time, it);
     }
+    connect_bands(trigger_time, md_location);
   } else {
     Client::renew(trigger_time, md_location);
   }
@@ -12,6 +12,7 @@ using namespace kungfu::longfist::enums;
 using namespace kungfu::yijinjing::practice;
 using namespace kungfu::yijinjing;
 using namespace kungfu::yijinjing::data;
+using namespace kungfu::yijinjing::journal;
 
 namespace kungfu::wingchun::broker {
 MarketDataVendor::MarketDataVendor(locator_ptr locator, const std::string &group, const std::string &name,
@@ -62,4 +63,22 @@ void MarketData::try_subscribe() {
 
 void MarketData::add_instrument_key(const InstrumentKey &key) { instruments_to_subscribe_.push_back(key); }
 
+void MarketData::request_md_shards(uint32_t shard_count) {
+  md_shard_uids_.clear();
+  for (uint32_t shard = 0; shard < shard_count; shard++) {
+    md_shard_uids_.push_back(request_band(get_md_shard_name(shard, shard_count)));
+  }
+  SPDLOG_INFO("market data sharded into {} bands", shard_count);
+}
+
+writer_ptr MarketData::get_md_writer(const char *exchange_id, const char *instrument_id) const {
+  if (not md_shard_uids_.empty()) {
+    auto shard_uid = md_shard_uids_[get_md_shard(exchange_id, instrument_id, md_shard_uids_.size())];
+    if (has_writer(shard_uid)) {
+      return get_writer(shard_uid);
+    }
+  }
+  return get_writer(location::PUBLIC);
+}
+
 } // namespace kungfu::wingchun::broker
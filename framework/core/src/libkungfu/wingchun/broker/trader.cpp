@@ -43,6 +43,7 @@ void TraderVendor::on_start() {
   events_ | is(OrderTradeRequest::tag) | $$(service_->req_order_trade());
   events_ | is(Deregister::tag) | $$(service_->on_strategy_exit(event));
   events_ | is(TimeKeyValue::tag) | $$(service_->on_time_key_value(event));
+  events_ | is(Quote::tag) | $$(service_->on_quote(event));
   events_ | is(PositionRequest::tag) | $$(service_->req_position());
   events_ | is(RequestHistoryOrder::tag) | $$(service_->req_history_order(event));
   events_ | is(RequestHistoryTrade::tag) | $$(service_->req_history_trade(event));
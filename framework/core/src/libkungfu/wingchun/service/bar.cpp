@@ -2,7 +2,6 @@
 #include <kungfu/wingchun/common.h>
 #include <kungfu/wingchun/service/bar.h>
 #include <kungfu/yijinjing/log.h>
-#include <regex>
 
 using namespace kungfu::longfist::types;
 using namespace kungfu::rx;
@@ -14,13 +13,13 @@ using namespace kungfu::yijinjing::data;
 
 namespace kungfu::wingchun::service {
 static int64_t parse_time_interval(const std::string &s) {
-  std::regex r("[0-9]+");
-  std::smatch m;
-  std::regex_search(s, m, r);
-  if (m.empty()) {
+  auto is_digit = [](char c) { return c >= '0' and c <= '9'; };
+  auto digits_begin = std::find_if(s.begin(), s.end(), is_digit);
+  auto digits_end = std::find_if_not(digits_begin, s.end(), is_digit);
+  if (digits_begin == digits_end) {
     throw std::runtime_error("invalid time interval: " + s);
   }
-  int n = std::stoi(m[0]);
+  int n = std::stoi(std::string(digits_begin, digits_end));
   if (endswith(s, "s")) {
     return n * time_unit::NANOSECONDS_PER_SECOND;
   } else if (endswith(s, "m")) {
@@ -34,16 +33,48 @@ static int64_t parse_time_interval(const std::string &s) {
   }
 }
 
+static std::vector<std::string> split_specs(const std::string &s) {
+  std::vector<std::string> result = {};
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (not item.empty()) {
+      result.push_back(item);
+    }
+  }
+  return result;
+}
+
 BarGenerator::BarGenerator(const locator_ptr &locator, mode m, bool low_latency, const std::string &json_config)
-    : MarketDataVendor(locator, "bar", "bar", low_latency),
-      time_interval_(kungfu::yijinjing::time_unit::NANOSECONDS_PER_MINUTE) {
+    : MarketDataVendor(locator, "bar", "bar", low_latency) {
   log::copy_log_settings(get_home(), "bar");
   auto config = nlohmann::json::parse(json_config);
   auto source = config["source"];
   source_location_ = location::make_shared(m, category::MD, source, source, get_locator());
+  std::vector<BarSpec> specs = {};
   if (config.find("time_interval") != config.end()) {
-    time_interval_ = parse_time_interval(config["time_interval"]);
+    for (const auto &item : split_specs(config["time_interval"])) {
+      specs.push_back({BarType::Time, parse_time_interval(item), 0, 0});
+    }
+  }
+  if (config.find("volume_interval") != config.end()) {
+    for (const auto &item : split_specs(config["volume_interval"])) {
+      specs.push_back({BarType::Volume, 0, std::stoll(item), 0});
+    }
   }
+  if (config.find("turnover_interval") != config.end()) {
+    for (const auto &item : split_specs(config["turnover_interval"])) {
+      specs.push_back({BarType::Turnover, 0, 0, std::stod(item)});
+    }
+  }
+  if (specs.empty()) {
+    specs.push_back({BarType::Time, time_unit::NANOSECONDS_PER_MINUTE, 0, 0});
+  }
+  if (config.find("tick_source") != config.end()) {
+    use_transaction_ = config["tick_source"] == "transaction";
+  }
+  aggregator_ = std::make_unique<BarAggregator>(
+      std::move(specs), [&](int64_t gen_time, const Bar &bar) { get_writer(location::PUBLIC)->write(gen_time, bar); });
 }
 
 void BarGenerator::on_start() {
@@ -57,56 +88,183 @@ void BarGenerator::on_start() {
     }
   });
 
-  events_ | is(Quote::tag) | $([&](const event_ptr &event) {
-    const auto &quote = event->data<Quote>();
-    auto instrument_key = hash_instrument(quote.exchange_id, quote.instrument_id);
-    auto pair = bars_.try_emplace(instrument_key);
-    auto &bar = pair.first->second;
-    if (pair.second) {
-      strncpy(bar.instrument_id, quote.instrument_id, INSTRUMENT_ID_LEN);
-      strncpy(bar.exchange_id, quote.exchange_id, EXCHANGE_ID_LEN);
-      bar.start_time = event->gen_time() - event->gen_time() % time_interval_;
-      bar.end_time = bar.start_time + time_interval_;
+  if (use_transaction_) {
+    events_ | is(Transaction::tag) | $([&](const event_ptr &event) {
+      on_tick(event->gen_time());
+      aggregator_->on_transaction(event->gen_time(), event->data<Transaction>());
+    });
+  } else {
+    events_ | is(Quote::tag) | $([&](const event_ptr &event) {
+      on_tick(event->gen_time());
+      aggregator_->on_quote(event->gen_time(), event->data<Quote>());
+    });
+  }
+}
+
+void BarGenerator::on_exit() {
+  auto duration = now() - first_tick_time_;
+  auto seconds = static_cast<double>(duration) / time_unit::NANOSECONDS_PER_SECOND;
+  auto tick_count = aggregator_->get_tick_count();
+  SPDLOG_INFO("processed {} ticks of {} instruments into {} bars with {} specs, {:.0f} ticks/s", tick_count,
+              aggregator_->get_instrument_count(), aggregator_->get_bar_count(), aggregator_->get_specs().size(),
+              seconds > 0 ? tick_count / seconds : 0);
+  MarketDataVendor::on_exit();
+}
+
+void BarGenerator::on_tick(int64_t gen_time) {
+  if (first_tick_time_ == 0) {
+    first_tick_time_ = gen_time;
+  }
+}
+
+BarAggregator::BarAggregator(std::vector<BarSpec> specs, BarHandler handler)
+    : specs_(std::move(specs)), handler_(std::move(handler)) {}
+
+void BarAggregator::on_quote(int64_t gen_time, const Quote &quote) {
+  size_t slot = find_slot(quote.exchange_id, quote.instrument_id, quote.instrument_type, quote.trading_day);
+  total_volumes_[slot] = quote.volume;
+  total_turnovers_[slot] = quote.turnover;
+  on_tick(gen_time, slot, quote.data_time, quote.last_price, 0, 0);
+}
+
+void BarAggregator::on_transaction(int64_t gen_time, const Transaction &transaction) {
+  size_t slot = find_slot(transaction.exchange_id, transaction.instrument_id, transaction.instrument_type,
+                          transaction.trading_day);
+  double turnover = transaction.price * transaction.volume;
+  total_volumes_[slot] += transaction.volume;
+  total_turnovers_[slot] += turnover;
+  on_tick(gen_time, slot, transaction.data_time, transaction.price, transaction.volume, turnover);
+}
+
+const std::vector<BarSpec> &BarAggregator::get_specs() const { return specs_; }
+
+size_t BarAggregator::get_instrument_count() const { return slots_.size(); }
+
+int64_t BarAggregator::get_tick_count() const { return tick_count_; }
+
+int64_t BarAggregator::get_bar_count() const { return bar_count_; }
+
+size_t BarAggregator::find_slot(const char *exchange_id, const char *instrument_id, InstrumentType type,
+                                const char *trading_day) {
+  auto instrument_key = hash_instrument(exchange_id, instrument_id);
+  auto pair = slots_.try_emplace(instrument_key, slots_.size());
+  auto slot = pair.first->second;
+  if (pair.second) {
+    Bar bar = {};
+    strncpy(bar.instrument_id, instrument_id, INSTRUMENT_ID_LEN);
+    strncpy(bar.exchange_id, exchange_id, EXCHANGE_ID_LEN);
+    strncpy(bar.trading_day, trading_day, DATE_LEN);
+    bar.instrument_type = type;
+    for (const auto &spec : specs_) {
+      bar.bar_type = spec.type;
+      bar.interval = spec.type == BarType::Time     ? spec.time_interval
+                     : spec.type == BarType::Volume ? spec.volume_threshold
+                                                    : std::llround(spec.turnover_threshold);
+      bars_.push_back(bar);
     }
-    if (quote.data_time >= bar.start_time && quote.data_time <= bar.end_time) {
-      if (bar.tick_count == 0) {
-        bar.high = quote.last_price;
-        bar.low = quote.last_price;
-        bar.open = quote.last_price;
-        bar.close = quote.last_price;
-        bar.start_volume = quote.volume;
+    bar_start_turnovers_.insert(bar_start_turnovers_.end(), specs_.size(), 0);
+    total_volumes_.push_back(0);
+    total_turnovers_.push_back(0);
+  }
+  return slot;
+}
+
+void BarAggregator::on_tick(int64_t gen_time, size_t slot, int64_t data_time, double price, int64_t tick_volume,
+                           double tick_turnover) {
+  tick_count_++;
+  auto total_volume = total_volumes_[slot];
+  auto total_turnover = total_turnovers_[slot];
+  auto offset = slot * specs_.size();
+  for (size_t i = 0; i < specs_.size(); i++) {
+    auto &bar = bars_[offset + i];
+    if (specs_[i].type == BarType::Time) {
+      update_time_bar(gen_time, specs_[i], bar, data_time, price, total_volume, tick_volume);
+    } else {
+      auto &start_turnover = bar_start_turnovers_[offset + i];
+      if (bar.end_time == 0) {
+        bar.start_volume = total_volume - tick_volume;
+        start_turnover = total_turnover - tick_turnover;
       }
-      bar.tick_count++;
-      bar.volume = quote.volume - bar.start_volume;
-      bar.high = std::max(bar.high, quote.last_price);
-      bar.low = std::min(bar.low, quote.last_price);
-      bar.close = quote.last_price;
+      update_size_bar(gen_time, specs_[i], bar, start_turnover, data_time, price, total_volume, total_turnover);
     }
-    if (quote.data_time >= bar.end_time) {
-      get_writer(location::PUBLIC)->write(event->gen_time(), bar);
-      bar.start_time = bar.end_time;
-      while (bar.start_time + time_interval_ < quote.data_time) {
-        bar.start_time += time_interval_;
-      }
-      bar.end_time = bar.start_time + time_interval_;
-      if (bar.start_time <= quote.data_time) {
-        bar.tick_count = 1;
-        bar.start_volume = quote.volume;
-        bar.volume = 0;
-        bar.high = quote.last_price;
-        bar.low = quote.last_price;
-        bar.open = quote.last_price;
-        bar.close = quote.last_price;
-      } else {
-        bar.tick_count = 0;
-        bar.start_volume = 0;
-        bar.volume = 0;
-        bar.high = 0;
-        bar.low = 0;
-        bar.open = 0;
-        bar.close = 0;
-      }
+  }
+}
+
+void BarAggregator::update_time_bar(int64_t gen_time, const BarSpec &spec, Bar &bar, int64_t data_time, double price,
+                                   int64_t total_volume, int64_t tick_volume) {
+  auto time_interval = spec.time_interval;
+  if (bar.end_time == 0) {
+    bar.start_time = gen_time - gen_time % time_interval;
+    bar.end_time = bar.start_time + time_interval;
+  }
+  if (data_time >= bar.start_time && data_time <= bar.end_time) {
+    if (bar.tick_count == 0) {
+      bar.high = price;
+      bar.low = price;
+      bar.open = price;
+      bar.close = price;
+      bar.start_volume = total_volume - tick_volume;
     }
-  });
+    bar.tick_count++;
+    bar.volume = total_volume - bar.start_volume;
+    bar.high = std::max(bar.high, price);
+    bar.low = std::min(bar.low, price);
+    bar.close = price;
+  }
+  if (data_time >= bar.end_time) {
+    write_bar(gen_time, bar);
+    bar.start_time = bar.end_time;
+    while (bar.start_time + time_interval < data_time) {
+      bar.start_time += time_interval;
+    }
+    bar.end_time = bar.start_time + time_interval;
+    if (bar.start_time <= data_time) {
+      bar.tick_count = 1;
+      bar.start_volume = total_volume - tick_volume;
+      bar.volume = tick_volume;
+      bar.high = price;
+      bar.low = price;
+      bar.open = price;
+      bar.close = price;
+    } else {
+      bar.tick_count = 0;
+      bar.start_volume = 0;
+      bar.volume = 0;
+      bar.high = 0;
+      bar.low = 0;
+      bar.open = 0;
+      bar.close = 0;
+    }
+  }
+}
+
+void BarAggregator::update_size_bar(int64_t gen_time, const BarSpec &spec, Bar &bar, double &start_turnover,
+                                   int64_t data_time, double price, int64_t total_volume, double total_turnover) {
+  if (bar.tick_count == 0) {
+    bar.start_time = data_time;
+    bar.high = price;
+    bar.low = price;
+    bar.open = price;
+  }
+  bar.tick_count++;
+  bar.end_time = data_time;
+  bar.volume = total_volume - bar.start_volume;
+  bar.high = std::max(bar.high, price);
+  bar.low = std::min(bar.low, price);
+  bar.close = price;
+  bool full = spec.type == BarType::Volume ? bar.volume >= spec.volume_threshold
+                                               : total_turnover - start_turnover >= spec.turnover_threshold;
+  if (full) {
+    write_bar(gen_time, bar);
+    bar.tick_count = 0;
+    bar.start_volume = total_volume;
+    bar.volume = 0;
+    start_turnover = total_turnover;
+  }
+}
+
+void BarAggregator::write_bar(int64_t gen_time, const Bar &bar) {
+  handler_(gen_time, bar);
+  bar_count_++;
 }
 } // namespace kungfu::wingchun::service
@@ -56,6 +56,9 @@ void Ledger::on_start() {
     add_time_interval(time_unit::NANOSECONDS_PER_MINUTE,
                       [&](const event_ptr &e) { request_position_sync(e->gen_time()); });
   }
+  latency_window_start_ = now();
+  add_time_interval(10 * time_unit::NANOSECONDS_PER_SECOND,
+                    [&](const event_ptr &e) { write_latency_stats(e->gen_time()); });
   refresh_books();
 }
 
@@ -108,6 +111,9 @@ void Ledger::update_order_stat(const event_ptr &event, const OrderInput &data) {
   stat.order_id = data.order_id;
   stat.md_time = event->trigger_time();
   stat.input_time = event->gen_time();
+  if (stat.md_time > 0 and stat.md_time <= stat.input_time) {
+    record_latency(event->source(), event->dest(), LatencyHop::MdToInput, stat.input_time - stat.md_time);
+  }
 }
 
 void Ledger::update_order_stat(const event_ptr &event, const Order &data) {
@@ -120,10 +126,14 @@ void Ledger::update_order_stat(const event_ptr &event, const Order &data) {
   if (not inserted) {
     stat.insert_time = event->gen_time();
     write_to(event->gen_time(), stat, event->source());
+    if (stat.input_time > 0) {
+      record_latency(event->dest(), event->source(), LatencyHop::InputToInsert, stat.insert_time - stat.input_time);
+    }
   }
   if (inserted and not acked) {
     stat.ack_time = event->gen_time();
     write_to(event->gen_time(), stat, event->source());
+    record_latency(event->dest(), event->source(), LatencyHop::InsertToAck, stat.ack_time - stat.insert_time);
   }
 }
 
@@ -131,6 +141,9 @@ void Ledger::update_order_stat(const event_ptr &event, const Trade &data) {
   write_book(event->gen_time(), event->source(), event->dest(), data);
   auto &stat = get_order_stat(data.order_id, event);
   if (stat.trade_time < event->gen_time()) {
+    if (stat.trade_time == 0 and stat.input_time > 0) {
+      record_latency(event->dest(), event->source(), LatencyHop::InputToTrade, event->gen_time() - stat.input_time);
+    }
     stat.trade_time = event->gen_time();
     stat.total_price += data.price * double(data.volume);
     stat.total_volume += double(data.volume);
@@ -141,6 +154,47 @@ void Ledger::update_order_stat(const event_ptr &event, const Trade &data) {
   }
 }
 
+void Ledger::record_latency(uint32_t strategy_uid, uint32_t account_uid, LatencyHop hop, int64_t latency) {
+  auto key = uint64_t(strategy_uid) << 32u | account_uid;
+  auto pair = latency_books_.try_emplace(key);
+  auto &latency_book = pair.first->second;
+  latency_book.strategy_uid = strategy_uid;
+  latency_book.account_uid = account_uid;
+  latency_book.hops[size_t(hop)].record(latency);
+}
+
+void Ledger::write_latency_stats(int64_t trigger_time) {
+  static_assert(yijinjing::util::histogram::BUCKET_COUNT == LATENCY_BUCKET_COUNT);
+  auto writer = get_writer(location::PUBLIC);
+  for (auto &pair : latency_books_) {
+    auto &latency_book = pair.second;
+    for (size_t hop = 0; hop < LATENCY_HOP_COUNT; hop++) {
+      auto &histogram = latency_book.hops[hop];
+      if (histogram.count() == 0) {
+        continue;
+      }
+      LatencyStat &stat = writer->open_data<LatencyStat>(trigger_time);
+      stat.strategy_uid = latency_book.strategy_uid;
+      stat.account_uid = latency_book.account_uid;
+      stat.hop = LatencyHop(hop);
+      stat.update_time = trigger_time;
+      stat.window = trigger_time - latency_window_start_;
+      stat.count = histogram.count();
+      stat.min = histogram.min();
+      stat.max = histogram.max();
+      stat.mean = histogram.mean();
+      stat.p50 = histogram.percentile(0.5);
+      stat.p90 = histogram.percentile(0.9);
+      stat.p99 = histogram.percentile(0.99);
+      stat.p999 = histogram.percentile(0.999);
+      memcpy(stat.buckets.value, histogram.buckets().data(), sizeof(stat.buckets.value));
+      writer->close_data();
+      histogram.reset();
+    }
+  }
+  latency_window_start_ = trigger_time;
+}
+
 void Ledger::update_account_book(int64_t trigger_time, uint32_t account_uid) {
   refresh_account_book(trigger_time, account_uid);
   auto writer = get_writer(account_uid);
@@ -4,6 +4,7 @@
 // Created by Keren Dong on 2019-06-20.
 //
 
+#include <kungfu/wingchun/common.h>
 #include <kungfu/wingchun/strategy/context.h>
 
 using namespace kungfu::yijinjing::practice;
@@ -28,4 +29,19 @@ void Context::bypass_accounting() { bypass_accounting_ = true; }
 
 bool Context::is_bypass_accounting() const { return bypass_accounting_; }
 
+void Context::conflate_quotes(int64_t lag_threshold) {
+  quote_conflation_threshold_ = std::max<int64_t>(lag_threshold, 0);
+}
+
+int64_t Context::get_quote_conflation_threshold() const { return quote_conflation_threshold_; }
+
+void Context::batch_market_data() { market_data_batched_ = true; }
+
+bool Context::is_market_data_batched() const { return market_data_batched_; }
+
+uint64_t Context::get_conflated_quote_count(const std::string &exchange_id, const std::string &instrument_id) const {
+  auto iter = conflated_quote_counts_.find(hash_instrument(exchange_id.c_str(), instrument_id.c_str()));
+  return iter == conflated_quote_counts_.end() ? 0 : iter->second;
+}
+
 } // namespace kungfu::wingchun::strategy
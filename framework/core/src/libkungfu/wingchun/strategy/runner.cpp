@@ -4,7 +4,9 @@
 // Created by Keren Dong on 2019-06-20.
 //
 
+#include <kungfu/wingchun/common.h>
 #include <kungfu/wingchun/strategy/runner.h>
+#include <kungfu/yijinjing/time.h>
 
 using namespace kungfu::rx;
 using namespace kungfu::longfist::enums;
@@ -66,6 +68,8 @@ void Runner::on_start() {
 }
 
 void Runner::on_active() {
+  flush_conflated_quotes();
+  flush_batches();
   if (not is_live()) {
     pre_stop();
   }
@@ -78,14 +82,21 @@ void Runner::post_start() {
     return; // safe guard for live mode, in that case we will run truly when prepare process is done.
   }
 
-  events_ | is_own<Quote>(context_->get_broker_client()) |
-      $$(invoke(&Strategy::on_quote, event->data<Quote>(), get_location(event->source())));
+  // conflated quotes go out before any other event, and batched market data before any event other than market data,
+  // so that strategies never see events ahead of the market data that preceded them in the journal
+  events_ | filter([](const event_ptr &event) { return event->msg_type() != Quote::tag; }) |
+      $$(flush_conflated_quotes());
+  events_ | filter([](const event_ptr &event) {
+    auto msg_type = event->msg_type();
+    return msg_type != Quote::tag and msg_type != Entrust::tag and msg_type != Transaction::tag;
+  }) | $$(flush_batches());
+  events_ | is_own<Quote>(context_->get_broker_client()) | $$(on_quote(event));
   events_ | is_own<Tree>(context_->get_broker_client()) |
       $$(invoke(&Strategy::on_tree, event->data<Tree>(), get_location(event->source())));
   events_ | is_own<Entrust>(context_->get_broker_client()) |
-      $$(invoke(&Strategy::on_entrust, event->data<Entrust>(), get_location(event->source())));
+      $$(deliver(&Strategy::on_entrust, event->data<Entrust>(), event->source()));
   events_ | is_own<Transaction>(context_->get_broker_client()) |
-      $$(invoke(&Strategy::on_transaction, event->data<Transaction>(), get_location(event->source())));
+      $$(deliver(&Strategy::on_transaction, event->data<Transaction>(), event->source()));
   events_ | is(Order::tag) | $$(invoke(&Strategy::on_order, event->data<Order>(), get_location(event->source())));
   events_ | is(Trade::tag) | $$(invoke(&Strategy::on_trade, event->data<Trade>(), get_location(event->source())));
   events_ | is_custom() |
@@ -118,6 +129,58 @@ void Runner::pre_stop() { invoke(&Strategy::pre_stop); }
 
 void Runner::post_stop() { invoke(&Strategy::post_stop); }
 
+void Runner::on_quote(const event_ptr &event) {
+  const Quote &quote = event->data<Quote>();
+  auto lag_threshold = context_->get_quote_conflation_threshold();
+  if (lag_threshold <= 0 or get_io_device()->get_home()->mode != mode::LIVE) {
+    deliver(&Strategy::on_quote, quote, event->source());
+    return;
+  }
+  auto now_time = time::now_in_nano();
+  bool lagging = now_time - event->gen_time() > lag_threshold;
+  if (not lagging and conflated_quotes_.empty()) {
+    deliver(&Strategy::on_quote, quote, event->source());
+    return;
+  }
+  // keep only the latest quote of each instrument while lagging, delivered once the reader catches up, or once per
+  // window of lag_threshold or QUOTE_CONFLATION_WINDOW_COUNT quotes if it stays behind
+  if (conflated_quotes_.empty()) {
+    conflation_window_start_ = now_time;
+    conflation_window_count_ = 0;
+  }
+  conflation_window_count_++;
+  auto instrument_key = hash_instrument(quote.exchange_id, quote.instrument_id);
+  auto pair = conflated_quote_slots_.try_emplace(instrument_key, conflated_quotes_.size());
+  if (pair.second) {
+    conflated_quotes_.emplace_back(quote, event->source());
+  } else {
+    conflated_quotes_[pair.first->second] = {quote, event->source()};
+    context_->conflated_quote_counts_[instrument_key]++;
+  }
+  if (not lagging or now_time - conflation_window_start_ >= lag_threshold or
+      conflation_window_count_ >= QUOTE_CONFLATION_WINDOW_COUNT) {
+    flush_conflated_quotes();
+  }
+}
+
+void Runner::flush_conflated_quotes() {
+  if (conflated_quotes_.empty()) {
+    return;
+  }
+  for (const auto &pair : conflated_quotes_) {
+    deliver(&Strategy::on_quote, pair.first, pair.second);
+  }
+  conflated_quotes_.clear();
+  conflated_quote_slots_.clear();
+}
+
+void Runner::flush_batches() {
+  if (not market_data_batch_.empty()) {
+    invoke(&Strategy::on_market_data, market_data_batch_);
+    market_data_batch_.clear();
+  }
+}
+
 void Runner::prepare(const event_ptr &event) {
   if (event->msg_type() == Position::tag) {
     const Position &position = event->data<Position>();
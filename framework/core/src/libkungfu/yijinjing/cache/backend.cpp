@@ -20,6 +20,7 @@ void shift::ensure_storage(uint32_t dest) {
   auto storage = make_storage_ptr(db_file, longfist::StateDataTypes);
   storage->pragma.journal_mode(sqlite_orm::journal_mode::WAL);
   storage->sync_schema();
+  index_timestamps(storage, longfist::StateDataTypes);
   storage_map_.emplace(dest, storage);
 }
 } // namespace kungfu::yijinjing::cache
@@ -4,7 +4,11 @@
 // Created by Keren Dong on 2020/3/27.
 //
 
+#include <atomic>
 #include <fstream>
+#include <map>
+#include <optional>
+#include <thread>
 #include <kungfu/yijinjing/index/session.h>
 
 using namespace sqlite_orm;
@@ -113,55 +117,157 @@ void session_builder::update_session(const frame_ptr &frame) {
   session.data_size += frame->frame_length();
 }
 
-[[maybe_unused]] void session_builder::rebuild_index_db() {
-  std::unordered_map<std::string, location_ptr> formatstr_to_locations = {};
-  auto locator = io_device_->get_locator();
-  auto reader = io_device_->open_reader_to_subscribe();
-  for (const auto &location : locator->list_locations("*", "*", "*", "*")) {
-    SPDLOG_TRACE("investigating journal for [{:08x}] {}", location->uid, location->uname);
+/**
+ * Sessions of one app are marked in its master command journal system/master/{app uid}, sessions of master itself
+ * in system/master/master, so each of these journal locations can be scanned independently of others.
+ */
+struct session_index_task {
+  location_ptr journal_location;
+  location_ptr session_location;
+  std::optional<Session> last_session;
+  std::unordered_map<uint32_t, SessionIndex> checkpoints;
+  std::map<int64_t, Session> sessions;
+};
 
-    if (location->category != category::SYSTEM or location->group != "master") {
-      formatstr_to_locations.emplace(fmt::format("{:08x}", location->uid), location);
+static void scan_session_index(session_index_task &task, const reader_ptr &reader) {
+  auto &journal_location = task.journal_location;
+  auto &session_location = task.session_location;
+  auto count_frames = journal_location->name == "master";
+  for (const auto dest_uid : journal_location->locator->list_location_dest(journal_location)) {
+    auto pair = task.checkpoints.try_emplace(dest_uid);
+    auto &checkpoint = pair.first->second;
+    if (pair.second) {
+      checkpoint.location_uid = journal_location->uid;
+      checkpoint.dest_id = dest_uid;
     }
+    // resume strictly after the last frame indexed, from the page that holds it
+    reader->resume(journal_location, dest_uid, checkpoint.page_id, checkpoint.frame_time);
+  }
 
-    if (location->category == category::SYSTEM and location->group == "master" and location->name == "master") {
-      formatstr_to_locations.emplace(location->name, location);
+  auto &session = task.last_session;
+  page_ptr last_page = {};
+  SessionIndex *checkpoint = nullptr;
+  while (reader->data_available()) {
+    auto frame = reader->current_frame();
+    auto page = reader->current_page();
+    if (page != last_page) {
+      checkpoint = &task.checkpoints.at(page->get_dest_id());
+      checkpoint->page_id = page->get_page_id();
+      last_page = page;
     }
+    checkpoint->frame_time = frame->gen_time();
 
-    for (const auto dest_uid : locator->list_location_dest(location)) {
-      reader->join(location, dest_uid, 0);
+    if (frame->msg_type() == SessionStart::tag) {
+      if (session.has_value()) {
+        task.sessions.insert_or_assign(session->begin_time, *session);
+      } else {
+        session = Session{};
+        session->location_uid = session_location->uid;
+        session->category = session_location->category;
+        session->group = session_location->group;
+        session->name = session_location->name;
+        session->mode = session_location->mode;
+      }
+      session->begin_time = frame->gen_time();
+      session->end_time = 0;
+      session->update_time = frame->gen_time();
+    } else if (frame->msg_type() == SessionEnd::tag and session.has_value()) {
+      session->end_time = frame->gen_time();
+      session->update_time = frame->gen_time();
+    } else if (count_frames and session.has_value() and frame->source() == session_location->uid) {
+      session->update_time = frame->gen_time();
+      session->frame_count++;
+      session->data_size += frame->frame_length();
     }
+    reader->next();
+  }
+  if (session.has_value()) {
+    task.sessions.insert_or_assign(session->begin_time, *session);
   }
+}
 
-  session_storage_->remove_all<Session>();
-  while (reader->data_available()) {
-    auto location = reader->current_page()->get_location();
-    std::string uid_str = location->name;
-    auto frame = reader->current_frame();
-    if (formatstr_to_locations.find(uid_str) == formatstr_to_locations.end()) {
-      reader->next();
+[[maybe_unused]] void session_builder::rebuild_index_db(bool incremental, uint32_t thread_count) {
+  auto locator = io_device_->get_locator();
+  auto locations = locator->list_locations("*", "*", "*", "*");
+  std::unordered_map<std::string, location_ptr> formatstr_to_locations = {};
+  for (const auto &location : locations) {
+    if (location->category != category::SYSTEM or location->group != "master") {
+      formatstr_to_locations.emplace(fmt::format("{:08x}", location->uid), location);
+    }
+  }
+
+  std::unordered_map<uint32_t, std::unordered_map<uint32_t, SessionIndex>> checkpoints = {};
+  if (incremental) {
+    for (const auto &checkpoint : session_storage_->get_all<SessionIndex>()) {
+      checkpoints[checkpoint.location_uid].emplace(checkpoint.dest_id, checkpoint);
+    }
+  }
+
+  std::vector<session_index_task> tasks = {};
+  for (const auto &location : locations) {
+    if (location->category != category::SYSTEM or location->group != "master") {
       continue;
     }
+    auto is_master = location->name == "master";
+    auto iter = formatstr_to_locations.find(location->name);
+    if (not is_master and iter == formatstr_to_locations.end()) {
+      continue;
+    }
+    session_index_task task = {location, is_master ? location : iter->second};
+    if (incremental and checkpoints.find(location->uid) != checkpoints.end()) {
+      task.checkpoints = std::move(checkpoints.at(location->uid));
+      auto match_uid = where(eq(&Session::location_uid, task.session_location->uid));
+      auto sessions = session_storage_->get_all<Session>(match_uid, order_by(&Session::begin_time).desc(), limit(1));
+      if (not sessions.empty()) {
+        task.last_session = sessions.front();
+      }
+    }
+    tasks.push_back(std::move(task));
+  }
 
-    try {
-      if (frame->msg_type() == SessionStart::tag) {
-        open_session(formatstr_to_locations.at(uid_str), frame->gen_time());
-      } else if (frame->msg_type() == SessionEnd::tag) {
-        close_session(formatstr_to_locations.at(uid_str), frame->gen_time());
-      } else if (location->category != category::SYSTEM or location->group != "master") {
-        update_session(frame);
-      } else if (location->category == category::SYSTEM and location->group == "master" and
-                 location->name == "master") {
-        update_session(frame);
+  if (thread_count == 0) {
+    thread_count = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+  }
+  thread_count = std::min<uint32_t>(thread_count, tasks.size());
+
+  std::atomic<size_t> next_task = 0;
+  auto work = [&]() {
+    for (auto i = next_task++; i < tasks.size(); i = next_task++) {
+      auto &task = tasks.at(i);
+      SPDLOG_TRACE("investigating journal for [{:08x}] {}", task.journal_location->uid, task.journal_location->uname);
+      try {
+        scan_session_index(task, io_device_->open_reader_to_subscribe());
+      } catch (const std::exception &ex) {
+        SPDLOG_ERROR("problematic journal at {}, {}, {}", task.journal_location->uname, task.session_location->uname,
+                     ex.what());
       }
-    } catch (const std::exception &ex) {
-      SPDLOG_ERROR("problematic frame at {}, {}, {}", location->uname, formatstr_to_locations.at(uid_str)->uname,
-                   ex.what());
     }
-    reader->next();
+  };
+  std::vector<std::thread> workers = {};
+  for (uint32_t i = 0; i < thread_count; i++) {
+    workers.emplace_back(work);
   }
-  for (const auto &pair : live_sessions_) {
-    session_storage_->replace(pair.second);
+  for (auto &worker : workers) {
+    worker.join();
   }
+
+  session_storage_->transaction([&]() {
+    if (not incremental) {
+      session_storage_->remove_all<Session>();
+      session_storage_->remove_all<SessionIndex>();
+    }
+    for (const auto &task : tasks) {
+      for (const auto &pair : task.sessions) {
+        session_storage_->replace(pair.second);
+      }
+      for (const auto &pair : task.checkpoints) {
+        session_storage_->replace(pair.second);
+      }
+      if (task.last_session.has_value()) {
+        live_sessions_.insert_or_assign(task.session_location->uid, *task.last_session);
+      }
+    }
+    return true;
+  });
 }
 } // namespace kungfu::yijinjing::index
\ No newline at end of file
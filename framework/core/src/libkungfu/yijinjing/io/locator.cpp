@@ -5,10 +5,19 @@
 //
 
 #include <algorithm>
+#include <cctype>
 #include <cstdlib>
 #include <kungfu/common.h>
 #include <kungfu/yijinjing/common.h>
+#include <mutex>
 #include <regex>
+#include <set>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 namespace kungfu::yijinjing::data {
 
@@ -33,6 +42,256 @@ fs::path get_default_root() {
   return root / "kungfu" / "home";
 }
 
+#ifdef __linux__
+
+/**
+ * In memory index of journal files under one root, laid out as {category}/{group}/{name}/journal/{mode}/{dest}.{page}.
+ * It is built by one walk of the root, then kept current by draining inotify events before every lookup. The kernel
+ * queues an event as soon as any process creates a page file, so a lookup never misses a page that already exists.
+ */
+class journal_dir_index {
+public:
+  struct journal_dir {
+    std::string category;
+    std::string group;
+    std::string name;
+    std::string mode;
+    std::unordered_map<uint32_t, std::set<uint32_t>> pages;
+  };
+
+  explicit journal_dir_index(fs::path root) : root_(std::move(root)), pid_(getpid()), root_found_(fs::exists(root_)) {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    valid_ = fd_ >= 0 and build();
+  }
+
+  ~journal_dir_index() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  [[nodiscard]] bool is_valid() const { return valid_; }
+
+  [[nodiscard]] bool is_inherited() const { return pid_ != getpid(); }
+
+  [[nodiscard]] bool is_root_found() const { return root_found_; }
+
+  /**
+   * Calls visitor with each indexed journal dir, or only the one of given key if not empty.
+   * @return false if the index is no longer reliable and callers should scan directories instead
+   */
+  template <typename Visitor> bool visit(const std::string &key, Visitor &&visitor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (not valid_ or not drain()) {
+      return false;
+    }
+    if (key.empty()) {
+      for (const auto &pair : dirs_) {
+        visitor(pair.second);
+      }
+    } else if (auto iter = dirs_.find(key); iter != dirs_.end()) {
+      visitor(iter->second);
+    }
+    return true;
+  }
+
+  static std::string make_key(const std::vector<std::string> &components) {
+    std::string key = {};
+    for (const auto &component : components) {
+      key.append(key.empty() ? "" : "/").append(component);
+    }
+    return key;
+  }
+
+private:
+  /**
+   * Level of a watched directory below root, 0 root, 1 category, 2 group, 3 name, 4 journal, 5 mode.
+   * Components exclude the journal directory, so components of a mode directory form the key of its journal_dir.
+   */
+  struct watched_dir {
+    int level;
+    fs::path path;
+    std::vector<std::string> components;
+  };
+
+  const fs::path root_;
+  const pid_t pid_;
+  const bool root_found_;
+  int fd_ = -1;
+  bool valid_ = false;
+  std::mutex mutex_ = {};
+  std::unordered_map<int, watched_dir> watches_ = {};
+  std::unordered_map<std::string, journal_dir> dirs_ = {};
+
+  bool build() {
+    for (const auto &pair : watches_) {
+      inotify_rm_watch(fd_, pair.first);
+    }
+    watches_.clear();
+    dirs_.clear();
+    std::error_code ec;
+    return fs::is_directory(root_, ec) and walk({0, root_, {}});
+  }
+
+  bool walk(const watched_dir &dir) {
+    constexpr uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+    auto wd = inotify_add_watch(fd_, dir.path.c_str(), mask);
+    if (wd < 0) {
+      return errno == ENOENT; // removed right after created, nothing to index
+    }
+    watches_.insert_or_assign(wd, dir);
+    if (dir.level == 5) {
+      auto &c = dir.components;
+      dirs_.try_emplace(make_key(c), journal_dir{c[0], c[1], c[2], c[3], {}});
+    }
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(dir.path, ec); not ec and it != fs::directory_iterator(); it.increment(ec)) {
+      auto name = it->path().filename().string();
+      if (it->is_directory(ec)) {
+        if (not add_dir(dir, name)) {
+          return false;
+        }
+      } else {
+        add_file(dir, name);
+      }
+    }
+    return true;
+  }
+
+  bool add_dir(const watched_dir &parent, const std::string &name) {
+    if (parent.level >= 5 or (parent.level == 3 and name != "journal")) {
+      return true;
+    }
+    watched_dir dir = {parent.level + 1, parent.path / name, parent.components};
+    if (parent.level != 3) {
+      dir.components.push_back(name);
+    }
+    return walk(dir);
+  }
+
+  void remove_dir(const watched_dir &parent, const std::string &name) {
+    if (parent.level >= 5 or (parent.level == 3 and name != "journal")) {
+      return;
+    }
+    auto components = parent.components;
+    if (parent.level != 3) {
+      components.push_back(name);
+    }
+    auto prefix = make_key(components);
+    for (auto iter = dirs_.begin(); iter != dirs_.end();) {
+      const auto &key = iter->first;
+      auto matched = key.compare(0, prefix.size(), prefix) == 0 and
+                     (key.size() == prefix.size() or key[prefix.size()] == '/');
+      iter = matched ? dirs_.erase(iter) : std::next(iter);
+    }
+  }
+
+  void add_file(const watched_dir &dir, const std::string &name) {
+    uint32_t dest_id, page_id;
+    if (dir.level == 5 and parse_page_file(name, dest_id, page_id)) {
+      if (auto iter = dirs_.find(make_key(dir.components)); iter != dirs_.end()) {
+        iter->second.pages[dest_id].insert(page_id);
+      }
+    }
+  }
+
+  void remove_file(const watched_dir &dir, const std::string &name) {
+    uint32_t dest_id, page_id;
+    if (dir.level == 5 and parse_page_file(name, dest_id, page_id)) {
+      if (auto iter = dirs_.find(make_key(dir.components)); iter != dirs_.end()) {
+        auto &pages = iter->second.pages;
+        if (pages.count(dest_id) > 0 and pages.at(dest_id).erase(page_id) > 0 and pages.at(dest_id).empty()) {
+          pages.erase(dest_id);
+        }
+      }
+    }
+  }
+
+  /**
+   * Page files are named {dest_id:08x}.{page_id}.journal
+   */
+  static bool parse_page_file(const std::string &name, uint32_t &dest_id, uint32_t &page_id) {
+    static const std::string extension = ".journal";
+    auto dot = name.find('.');
+    if (dot == std::string::npos or name.size() <= extension.size() or
+        name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+      return false;
+    }
+    char *end = nullptr;
+    dest_id = std::strtoul(name.c_str(), &end, 16);
+    if (end != name.c_str() + dot) {
+      return false;
+    }
+    page_id = std::atoi(name.c_str() + dot + 1);
+    return true;
+  }
+
+  bool drain() {
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    while (true) {
+      auto length = read(fd_, buffer, sizeof(buffer));
+      if (length < 0 and errno == EINTR) {
+        continue;
+      }
+      if (length <= 0) {
+        return length == 0 or errno == EAGAIN or errno == EWOULDBLOCK;
+      }
+      for (char *p = buffer; p < buffer + length;) {
+        auto event = reinterpret_cast<struct inotify_event *>(p);
+        p += sizeof(struct inotify_event) + event->len;
+        if (event->mask & IN_Q_OVERFLOW) {
+          valid_ = build();
+          return valid_;
+        }
+        auto iter = watches_.find(event->wd);
+        if (iter == watches_.end()) {
+          continue;
+        }
+        if (event->mask & IN_IGNORED) {
+          watches_.erase(iter);
+          continue;
+        }
+        auto parent = iter->second;
+        std::string name = event->len > 0 ? event->name : "";
+        bool is_dir = event->mask & IN_ISDIR;
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+          if (is_dir and not add_dir(parent, name)) {
+            valid_ = false;
+            return false;
+          }
+          if (not is_dir) {
+            add_file(parent, name);
+          }
+        } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+          if (is_dir) {
+            remove_dir(parent, name);
+          } else {
+            remove_file(parent, name);
+          }
+        }
+      }
+    }
+  }
+};
+DECLARE_PTR(journal_dir_index)
+
+/**
+ * One index per root shared by all locators of the process. It is rebuilt in forked children, since an inherited
+ * inotify descriptor would share its event queue with the parent, and retried while the root does not exist yet.
+ */
+static journal_dir_index_ptr get_journal_dir_index(const fs::path &root) {
+  static std::mutex mutex = {};
+  static std::unordered_map<std::string, journal_dir_index_ptr> indices = {};
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &index = indices[root.string()];
+  if (index == nullptr or index->is_inherited() or (not index->is_valid() and not index->is_root_found())) {
+    index = std::make_shared<journal_dir_index>(root);
+  }
+  return index->is_valid() ? index : nullptr;
+}
+
+#endif // __linux__
+
 std::string get_runtime_dir() {
   auto runtime_dir = std::getenv("KF_RUNTIME_DIR");
   if (runtime_dir != nullptr) {
@@ -109,10 +368,28 @@ std::string locator::layout_file(const location_ptr &location, es::layout layout
   return db_file;
 }
 
+#ifdef __linux__
+static std::string make_journal_dir_key(const location_ptr &location) {
+  return journal_dir_index::make_key({es::get_category_name(location->category), location->group, location->name,
+                                      es::get_mode_name(location->mode)});
+}
+#endif
+
 std::vector<uint32_t> locator::list_page_id(const location_ptr &location, uint32_t dest_id) const {
   std::vector<uint32_t> result = {};
   auto dest_id_str = fmt::format("{:08x}", dest_id);
   auto dir = fs::path(layout_dir(location, es::layout::JOURNAL));
+#ifdef __linux__
+  auto index = get_journal_dir_index(root_);
+  if (index and index->visit(make_journal_dir_key(location), [&](const auto &journal_dir) {
+        auto iter = journal_dir.pages.find(dest_id);
+        if (iter != journal_dir.pages.end()) {
+          result.assign(iter->second.begin(), iter->second.end());
+        }
+      })) {
+    return result;
+  }
+#endif
   for (auto &it : fs::recursive_directory_iterator(dir)) {
     auto basename = it.path().stem();
     if (it.is_regular_file() and it.path().extension() == ".journal" and basename.stem() == dest_id_str) {
@@ -128,8 +405,45 @@ static constexpr auto w = [](const std::string &pattern) { return pattern == "*"
 
 static constexpr auto g = [](const std::string &pattern) { return fmt::format("({})", w(pattern)); };
 
+/**
+ * Matches one path component as the search regex would, without compiling a regex for plain names.
+ */
+static std::function<bool(const std::string &)> make_matcher(const std::string &pattern) {
+  if (pattern == "*" or pattern == ".*") {
+    return [](const std::string &) { return true; };
+  }
+  if (pattern.find_first_of(".*+?|()[]{}^$\\") == std::string::npos) {
+    return [pattern](const std::string &value) { return value == pattern; };
+  }
+  auto regex = std::regex(w(pattern));
+  return [regex](const std::string &value) { return std::regex_match(value, regex); };
+}
+
 std::vector<location_ptr> locator::list_locations(const std::string &category, const std::string &group,
                                                   const std::string &name, const std::string &mode) const {
+#ifdef __linux__
+  auto index = get_journal_dir_index(root_);
+  if (index) {
+    std::vector<location_ptr> result = {};
+    auto match_category = make_matcher(category);
+    auto match_group = make_matcher(group);
+    auto match_name = make_matcher(name);
+    auto match_mode = make_matcher(mode);
+    auto shared_locator = std::make_shared<locator>(root_.string());
+    if (index->visit("", [&](const auto &journal_dir) {
+          if (match_category(journal_dir.category) and match_group(journal_dir.group) and
+              match_name(journal_dir.name) and match_mode(journal_dir.mode)) {
+            result.push_back(location::make_shared(es::get_mode_by_name(journal_dir.mode),         //
+                                                   es::get_category_by_name(journal_dir.category), //
+                                                   journal_dir.group,                              //
+                                                   journal_dir.name,                               //
+                                                   shared_locator));
+          }
+        })) {
+      return result;
+    }
+  }
+#endif
   fs::path search_path = root_ / g(category) / g(group) / g(name) / "journal" / g(mode);
   std::string pattern = std::regex_replace(search_path.string(), std::regex("\\\\"), "\\\\");
   std::regex search_regex(pattern);
@@ -152,6 +466,16 @@ std::vector<location_ptr> locator::list_locations(const std::string &category, c
 std::vector<uint32_t> locator::list_location_dest(const location_ptr &location) const {
   std::unordered_set<uint32_t> set = {};
   auto dir = fs::path(layout_dir(location, es::layout::JOURNAL));
+#ifdef __linux__
+  auto index = get_journal_dir_index(root_);
+  if (index and index->visit(make_journal_dir_key(location), [&](const auto &journal_dir) {
+        for (const auto &pair : journal_dir.pages) {
+          set.emplace(pair.first);
+        }
+      })) {
+    return std::vector<uint32_t>{set.begin(), set.end()};
+  }
+#endif
   for (auto &it : fs::recursive_directory_iterator(dir)) {
     auto basename = it.path().stem();
     if (it.is_regular_file() and it.path().extension() == ".journal") {
@@ -173,6 +497,72 @@ std::vector<uint32_t> locator::list_location_dest_by_db(const location_ptr &loca
   return std::vector<uint32_t>{set.begin(), set.end()};
 }
 
+/**
+ * Parses size like 256M, 64KB, 1G or plain bytes, returns 0 if not a valid page size.
+ */
+static uint32_t parse_page_size(const std::string &text) {
+  char *end = nullptr;
+  auto size = std::strtoull(text.c_str(), &end, 10);
+  switch (std::toupper(*end)) {
+  case 'G':
+    size *= 1024;
+    [[fallthrough]];
+  case 'M':
+    size *= 1024;
+    [[fallthrough]];
+  case 'K':
+    size *= 1024;
+    end++;
+    break;
+  default:
+    break;
+  }
+  end += std::toupper(*end) == 'B' ? 1 : 0;
+  auto valid = *end == '\0' and size >= MIN_PAGE_SIZE and size <= MAX_PAGE_SIZE and size % (4 * KB) == 0;
+  return valid ? static_cast<uint32_t>(size) : 0;
+}
+
+uint32_t locator::get_page_size(const location_ptr &location, uint32_t dest_id) const {
+  if (has_env(JOURNAL_PAGE_SIZE_ENV)) {
+    const std::vector<std::string> components = {es::get_category_name(location->category), location->group,
+                                                 location->name, es::get_mode_name(location->mode)};
+    uint32_t rule_size = 0;
+    int best_specificity = -1;
+    std::stringstream rules(get_env(JOURNAL_PAGE_SIZE_ENV));
+    std::string rule;
+    while (std::getline(rules, rule, ',')) {
+      auto separator = rule.find('=');
+      auto size = separator == std::string::npos ? 0 : parse_page_size(rule.substr(separator + 1));
+      if (size == 0) {
+        SPDLOG_WARN("invalid journal page size rule [{}] in {}", rule, JOURNAL_PAGE_SIZE_ENV);
+        continue;
+      }
+      std::stringstream patterns(rule.substr(0, separator));
+      std::string pattern;
+      int specificity = 0;
+      bool matched = true;
+      for (size_t i = 0; matched and std::getline(patterns, pattern, '/'); i++) {
+        matched = i < components.size() and (pattern == "*" or pattern == components[i]);
+        specificity += pattern == "*" ? 0 : 1;
+      }
+      if (matched and specificity > best_specificity) {
+        rule_size = size;
+        best_specificity = specificity;
+      }
+    }
+    if (rule_size > 0) {
+      return rule_size;
+    }
+  }
+  if (location->category == es::category::MD && dest_id != 1) {
+    return 128 * MB;
+  }
+  if ((location->category == es::category::TD || location->category == es::category::STRATEGY) && dest_id != 0) {
+    return 16 * MB;
+  }
+  return MB;
+}
+
 bool locator::operator==(const locator &another) const {
   return dir_mode_ == another.dir_mode_ and root_.string() == another.root_.string();
 }
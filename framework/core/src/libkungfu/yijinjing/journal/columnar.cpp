@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <kungfu/yijinjing/journal/columnar.h>
+#include <kungfu/yijinjing/log.h>
+
+namespace fs = std::filesystem;
+
+namespace kungfu::yijinjing::journal {
+using namespace longfist::enums;
+using namespace longfist::types;
+
+static constexpr size_t COLUMN_BUFFER_SIZE = 1 << 20;
+
+columnar_sink::columnar_sink(std::string output_dir, const std::vector<std::string> &type_names, int64_t begin_time,
+                             int64_t end_time, const std::vector<std::string> &instrument_ids)
+    : sink(), output_dir_(std::move(output_dir)), begin_time_(begin_time), end_time_(end_time),
+      instrument_ids_(instrument_ids.begin(), instrument_ids.end()) {
+  boost::hana::for_each(longfist::AllDataTypes, [&](auto it) {
+    using DataType = typename decltype(+boost::hana::second(it))::type;
+    if constexpr (size_fixed_v<DataType> and DataType::has_data) {
+      auto type_name = std::string(DataType::type_name.c_str());
+      if (std::find(type_names.begin(), type_names.end(), type_name) == type_names.end()) {
+        return;
+      }
+      table t = {type_name, SIZE_MAX, 0, 0, {}};
+      t.columns.push_back({"gen_time", numpy_dtype<int64_t>(), 1, 0, sizeof(int64_t), nullptr});
+      DataType sample = {};
+      auto base = reinterpret_cast<uintptr_t>(&sample);
+      boost::hana::for_each(boost::hana::accessors<DataType>(), [&](auto it) {
+        auto name = std::string(boost::hana::first(it).c_str());
+        auto accessor = boost::hana::second(it);
+        using AttrType = std::decay_t<decltype(accessor(sample))>;
+        auto offset = reinterpret_cast<uintptr_t>(&accessor(sample)) - base;
+        auto dtype = numpy_field_dtype<AttrType>();
+        column c = {name, dtype.first, dtype.second, offset, sizeof(AttrType), nullptr};
+        if (name == "instrument_id") {
+          t.instrument_id_offset = offset;
+          t.instrument_id_size = sizeof(AttrType);
+        }
+        t.columns.push_back(c);
+      });
+      tables_.emplace(DataType::tag, std::move(t));
+    }
+  });
+}
+
+columnar_sink::~columnar_sink() { close(); }
+
+void columnar_sink::put(const data::location_ptr &location, uint32_t dest_id, const frame_ptr &frame) {
+  auto gen_time = frame->gen_time();
+  if (gen_time < begin_time_ or gen_time >= end_time_) {
+    return;
+  }
+  auto it = tables_.find(frame->msg_type());
+  if (it == tables_.end()) {
+    return;
+  }
+  auto &t = it->second;
+  auto data = frame->data_as_bytes();
+  if (not instrument_ids_.empty() and t.instrument_id_offset != SIZE_MAX) {
+    auto instrument_id = data + t.instrument_id_offset;
+    if (instrument_ids_.find(std::string(instrument_id, strnlen(instrument_id, t.instrument_id_size))) ==
+        instrument_ids_.end()) {
+      return;
+    }
+  }
+  if (t.columns.front().file == nullptr) {
+    open_table(t);
+  }
+  fwrite(&gen_time, sizeof(gen_time), 1, t.columns.front().file);
+  for (size_t i = 1; i < t.columns.size(); i++) {
+    auto &c = t.columns[i];
+    fwrite(data + c.offset, c.size, 1, c.file);
+  }
+  t.rows++;
+}
+
+void columnar_sink::close() {
+  for (auto &pair : tables_) {
+    auto &t = pair.second;
+    if (t.columns.front().file == nullptr) {
+      continue;
+    }
+    for (auto &c : t.columns) {
+      fclose(c.file);
+      c.file = nullptr;
+    }
+    write_schema(t);
+  }
+}
+
+int64_t columnar_sink::get_rows() const {
+  int64_t rows = 0;
+  for (const auto &pair : tables_) {
+    rows += pair.second.rows;
+  }
+  return rows;
+}
+
+void columnar_sink::open_table(table &t) {
+  auto dir = fs::path(output_dir_) / t.type_name;
+  fs::create_directories(dir);
+  for (auto &c : t.columns) {
+    auto path = (dir / (c.name + ".bin")).string();
+    c.file = fopen(path.c_str(), "wb");
+    if (c.file == nullptr) {
+      throw journal_error("unable to open column file " + path);
+    }
+    setvbuf(c.file, nullptr, _IOFBF, COLUMN_BUFFER_SIZE);
+  }
+}
+
+void columnar_sink::write_schema(const table &t) const {
+  nlohmann::json schema = {};
+  schema["type"] = t.type_name;
+  schema["rows"] = t.rows;
+  for (const auto &c : t.columns) {
+    nlohmann::json column = {};
+    column["name"] = c.name;
+    column["dtype"] = c.dtype;
+    column["shape"] = c.length > 1 ? std::vector<size_t>{c.length} : std::vector<size_t>{};
+    column["file"] = c.name + ".bin";
+    schema["columns"].push_back(column);
+  }
+  std::ofstream of((fs::path(output_dir_) / t.type_name / "schema.json").string());
+  of << schema.dump(2);
+}
+
+[[maybe_unused]] int64_t export_columnar(const data::locator_ptr &locator, const std::string &output_dir,
+                                         const std::vector<std::string> &type_names, int64_t begin_time,
+                                         int64_t end_time, const std::vector<std::string> &instrument_ids,
+                                         const std::string &mode, const std::string &category,
+                                         const std::string &group, const std::string &name, uint32_t thread_count) {
+  auto locations = locator->list_locations(category, group, name, mode);
+  if (thread_count == 0) {
+    thread_count = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+  }
+  thread_count = std::min<uint32_t>(thread_count, locations.size());
+
+  std::atomic<size_t> next_location = 0;
+  std::atomic<int64_t> total_rows = 0;
+  auto work = [&]() {
+    for (auto i = next_location++; i < locations.size(); i = next_location++) {
+      const auto &location = locations.at(i);
+      auto sink = std::make_shared<columnar_sink>((fs::path(output_dir) / location->uname).string(), type_names,
+                                                  begin_time, end_time, instrument_ids);
+      assemble asb(location, 0, AssembleMode::Write, begin_time);
+      while (asb.data_available() and asb.current_frame()->gen_time() < end_time) {
+        sink->put(location, asb.current_frame()->dest(), asb.current_frame());
+        asb.next();
+      }
+      sink->close();
+      total_rows += sink->get_rows();
+      SPDLOG_INFO("exported {} rows of {}", sink->get_rows(), location->uname);
+    }
+  };
+
+  std::vector<std::thread> workers = {};
+  for (uint32_t i = 0; i < thread_count; i++) {
+    workers.emplace_back(work);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return total_rows;
+}
+} // namespace kungfu::yijinjing::journal
@@ -7,6 +7,9 @@
 #include <kungfu/yijinjing/time.h>
 
 namespace kungfu::yijinjing::journal {
+static constexpr int64_t PENDING_PAGE_CHECK_INTERVAL = time_unit::NANOSECONDS_PER_MILLISECOND;
+
+static const longfist::types::frame_header empty_frame_header = {};
 
 journal::~journal() {
   if (page_.get() != nullptr) {
@@ -27,7 +30,7 @@ void journal::next() {
 void journal::seek_to_time(int64_t nanotime) {
   int page_id = page::find_page_id(location_, dest_id_, nanotime);
   load_page(page_id);
-  while (page_->is_full() && page_->end_time() <= nanotime) {
+  while (page_ and page_->is_full() and page_->end_time() <= nanotime) {
     load_next_page();
   }
   while (frame_->has_data() && frame_->gen_time() <= nanotime) {
@@ -35,13 +38,36 @@ void journal::seek_to_time(int64_t nanotime) {
   }
 }
 
+void journal::seek_to_page(uint32_t page_id, int64_t nanotime) {
+  load_page(page_id);
+  while (frame_->has_data() && frame_->gen_time() <= nanotime) {
+    next();
+  }
+}
+
 void journal::load_page(int page_id) {
   if (page_.get() == nullptr or page_->get_page_id() != page_id) {
+    if (not is_writing_ and not page::is_initialized(location_, dest_id_, page_id)) {
+      page_.reset();
+      pending_page_id_ = page_id;
+      frame_->set_address(reinterpret_cast<uintptr_t>(&empty_frame_header));
+      page_frame_nb_ = 0u;
+      return;
+    }
     page_ = page::load(location_, dest_id_, page_id, is_writing_, lazy_);
   }
+  pending_page_id_ = 0;
   frame_->set_address(page_->first_frame_address());
   page_frame_nb_ = 0u;
 }
 
+void journal::load_pending_page(int64_t nanotime) {
+  if (pending_page_id_ == 0 or nanotime < pending_check_time_) {
+    return;
+  }
+  pending_check_time_ = nanotime + PENDING_PAGE_CHECK_INTERVAL;
+  load_page(pending_page_id_);
+}
+
 void journal::load_next_page() { load_page(page_->get_page_id() + 1); }
 } // namespace kungfu::yijinjing::journal
\ No newline at end of file
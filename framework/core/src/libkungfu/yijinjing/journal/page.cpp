@@ -1,5 +1,11 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
 #include <kungfu/common.h>
 #include <kungfu/yijinjing/journal/page.h>
 #include <kungfu/yijinjing/util/os.h>
@@ -24,11 +30,187 @@ void page::set_last_frame_position(uint64_t position) {
   const_cast<page_header *>(header_)->last_frame_position = position;
 }
 
+/**
+ * Keeps pre-faulted spare files for the pages a writer is going to roll over to, so that writing into a new page does
+ * not pay a zero-fill fault on the first touch of each memory page. Spares are created by a background thread next to
+ * the page they stand for, as {page}.spare, which is ignored by page listing, and are hard linked into place when the
+ * writer loads the page. Unused spares are removed at exit.
+ */
+class page_recycler {
+public:
+  static page_recycler &get_instance() {
+    static page_recycler instance = {};
+    return instance;
+  }
+
+  ~page_recycler() {
+    if (worker_ and pid_ != GETPID()) {
+      worker_.release(); // the worker thread and spare files belong to the parent process
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    condition_.notify_all();
+    if (worker_) {
+      worker_->join();
+    }
+    for (auto &pair : spares_) {
+      discard(pair.second);
+    }
+  }
+
+  /**
+   * Schedule preparation of a spare for page path, no-op if the page exists or a spare is already scheduled.
+   */
+  void prepare(const std::string &path, uint32_t page_size, bool lazy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_ and pid_ != GETPID()) {
+      return;
+    }
+    if (stopped_ or spares_.find(path) != spares_.end() or std::filesystem::exists(path)) {
+      return;
+    }
+    spares_.emplace(path, spare{path + ".spare", page_size, lazy, 0, false});
+    pending_.push_back(path);
+    if (not worker_) {
+      pid_ = GETPID();
+      worker_ = std::make_unique<std::thread>(&page_recycler::run, this);
+    }
+    condition_.notify_one();
+  }
+
+  /**
+   * Move the prepared spare of page path into place, a spare that is not ready yet is dropped.
+   * @return address of the mapped page, 0 if no spare of matching size is ready, caller should load the page as usual
+   */
+  uintptr_t acquire(const std::string &path, uint32_t page_size, bool lazy) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = spares_.find(path);
+    if (it == spares_.end()) {
+      return 0;
+    }
+    auto s = it->second;
+    spares_.erase(it);
+    lock.unlock();
+    if (not s.ready) {
+      return 0; // worker discards it once prepared
+    }
+    if (s.page_size != page_size or s.lazy != lazy) {
+      discard(s);
+      return 0;
+    }
+    // hard link fails if the page has been created meanwhile, rename would silently replace it
+    std::error_code ec = {};
+    std::filesystem::create_hard_link(s.path, path, ec);
+    if (ec) {
+      discard(s);
+      return 0;
+    }
+    std::filesystem::remove(s.path, ec);
+    return s.address;
+  }
+
+private:
+  struct spare {
+    std::string path;
+    uint32_t page_size;
+    bool lazy;
+    uintptr_t address;
+    bool ready;
+  };
+
+  std::mutex mutex_ = {};
+  std::condition_variable condition_ = {};
+  std::deque<std::string> pending_ = {};
+  std::unordered_map<std::string, spare> spares_ = {};
+  std::unique_ptr<std::thread> worker_ = {};
+  int pid_ = 0;
+  bool stopped_ = false;
+
+  page_recycler() = default;
+
+  void run() {
+    os::place_aux_thread();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      condition_.wait(lock, [&] { return stopped_ or not pending_.empty(); });
+      if (stopped_) {
+        return;
+      }
+      auto path = pending_.front();
+      pending_.pop_front();
+      auto s = spares_.at(path);
+      lock.unlock();
+      s.address = os::prefault_mmap_buffer(s.path, s.page_size, s.lazy);
+      lock.lock();
+      auto it = spares_.find(path);
+      if (s.address == 0 or stopped_ or it == spares_.end()) {
+        if (it != spares_.end()) {
+          spares_.erase(it);
+        }
+        discard(s);
+        continue;
+      }
+      it->second.address = s.address;
+      it->second.ready = true;
+    }
+  }
+
+  static void discard(const spare &s) {
+    if (s.address != 0) {
+      os::release_mmap_buffer(s.address, s.page_size, s.lazy);
+    }
+    std::error_code ec = {};
+    std::filesystem::remove(s.path, ec);
+  }
+};
+
+/**
+ * Number of pages ahead of the current one that a writer keeps spares for, 0 if page recycling is disabled.
+ */
+static uint32_t get_recycle_depth(const data::location_ptr &location) {
+  if (not location->locator->has_env(JOURNAL_PAGE_RECYCLE_ENV)) {
+    return 0;
+  }
+  auto value = location->locator->get_env(JOURNAL_PAGE_RECYCLE_ENV);
+  if (value == "on" or value == "true") {
+    return 1;
+  }
+  return std::min<uint32_t>(std::strtoul(value.c_str(), nullptr, 10), 16);
+}
+
+/**
+ * Page size recorded in header of an existing page, 0 if the page is not created or not initialized yet.
+ * It must be known before mapping, since a non lazy reader stretches the file to the size it maps.
+ */
+static uint32_t read_page_size(const std::string &path) {
+  page_header header = {};
+  std::ifstream file(path, std::ios::binary);
+  if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) and header.last_frame_position > 0 and
+      header.version == __JOURNAL_VERSION__) {
+    return header.page_size;
+  }
+  return 0;
+}
+
 page_ptr page::load(const data::location_ptr &location, uint32_t dest_id, uint32_t page_id, bool is_writing,
                     bool lazy) {
-  uint32_t page_size = find_page_size(location, dest_id);
   std::string path = get_page_path(location, dest_id, page_id);
-  uintptr_t address = os::load_mmap_buffer(path, page_size, is_writing, lazy);
+  uint32_t recorded_page_size = read_page_size(path);
+  if (not is_writing and recorded_page_size == 0) {
+    // page size comes from env of the writer, a reader must not guess it with its own
+    throw journal_error("page not initialized by its writer yet: " + path);
+  }
+  uint32_t page_size = recorded_page_size > 0 ? recorded_page_size : find_page_size(location, dest_id);
+  uint32_t recycle_depth = is_writing ? get_recycle_depth(location) : 0;
+  uintptr_t address = recycle_depth > 0 and recorded_page_size == 0
+                          ? page_recycler::get_instance().acquire(path, page_size, lazy)
+                          : 0;
+  if (address == 0) {
+    address = os::load_mmap_buffer(path, page_size, is_writing, lazy);
+  }
 
   // SPDLOG_TRACE("load page {}/{:08x}.{}.journal", location->uname, dest_id, page_id);
   // SPDLOG_TRACE("page_size {}, address {}", page_size, address);
@@ -37,6 +219,10 @@ page_ptr page::load(const data::location_ptr &location, uint32_t dest_id, uint32
     throw journal_error("unable to load page for " + path);
   }
 
+  if (is_writing) {
+    os::lock_placed_memory(address, page_size);
+  }
+
   page_header *header = reinterpret_cast<page_header *>(address);
   if (header->last_frame_position == 0) {
     header->version = __JOURNAL_VERSION__;
@@ -61,6 +247,11 @@ page_ptr page::load(const data::location_ptr &location, uint32_t dest_id, uint32
                     page_size, s, location->uname, path, dest_id, page_id));
   }
 
+  for (uint32_t i = 1; i <= recycle_depth; i++) {
+    auto next_page_path = get_page_path(location, dest_id, page_id + i);
+    page_recycler::get_instance().prepare(next_page_path, find_page_size(location, dest_id), lazy);
+  }
+
   return std::shared_ptr<page>(new page(location, dest_id, page_id, page_size, lazy, address));
 }
 
@@ -69,6 +260,10 @@ std::string page::get_page_path(const data::location_ptr &location, uint32_t des
   return location->locator->layout_file(location, longfist::enums::layout::JOURNAL, page_name);
 }
 
+bool page::is_initialized(const data::location_ptr &location, uint32_t dest_id, uint32_t page_id) {
+  return read_page_size(get_page_path(location, dest_id, page_id)) > 0;
+}
+
 uint32_t page::find_page_id(const data::location_ptr &location, uint32_t dest_id, int64_t time) {
   std::vector<uint32_t> page_ids = location->locator->list_page_id(location, dest_id);
   if (page_ids.empty()) {
@@ -78,6 +273,10 @@ uint32_t page::find_page_id(const data::location_ptr &location, uint32_t dest_id
     return page_ids.front();
   }
   for (int i = static_cast<int>(page_ids.size()) - 1; i >= 0; i--) {
+    // skip pages created ahead but not initialized yet, e.g. spares of page recycling
+    if (not is_initialized(location, dest_id, page_ids[i])) {
+      continue;
+    }
     if (page::load(location, dest_id, page_ids[i], false, true)->begin_time() < time) {
       return page_ids[i];
     }
@@ -18,6 +18,21 @@ void reader::join(const data::location_ptr &location, uint32_t dest_id, const in
   }
 }
 
+void reader::resume(const data::location_ptr &location, uint32_t dest_id, uint32_t page_id, int64_t frame_time) {
+  if (page_id == 0 or not page::is_initialized(location, dest_id, page_id)) {
+    join(location, dest_id, frame_time);
+    return;
+  }
+  auto key = static_cast<uint64_t>(location->uid) << 32u | static_cast<uint64_t>(dest_id);
+  auto result = journals_.try_emplace(key, location, dest_id, false, lazy_);
+  if (result.second) {
+    journals_.at(key).seek_to_page(page_id, frame_time);
+  }
+  if (current_ == nullptr) {
+    sort();
+  }
+}
+
 void reader::disjoin(const uint32_t location_uid) {
   for (auto it = journals_.begin(); it != journals_.end();) {
     if (it->first >> 32u xor location_uid) {
@@ -67,6 +82,7 @@ void reader::sort() {
   int64_t min_time = time::now_in_nano();
   for (auto &pair : journals_) {
     auto &journal = pair.second;
+    journal.load_pending_page(min_time);
     auto &frame = journal.current_frame();
     if (frame->has_data() && frame->gen_time() <= min_time) {
       min_time = frame->gen_time();
@@ -6,6 +6,7 @@
 
 #include <kungfu/common.h>
 #include <kungfu/yijinjing/practice/apprentice.h>
+#include <kungfu/yijinjing/practice/bootstrap.h>
 #include <kungfu/yijinjing/util/os.h>
 
 using namespace kungfu::rx;
@@ -146,6 +147,7 @@ void apprentice::on_trading_day(const event_ptr &event, int64_t daytime) {}
 
 void apprentice::react() {
   events_ | is(TimeReset::tag) | first() | $$(reset_time(event->data<TimeReset>()));
+  events_ | is(Bootstrap::tag) | $$(on_bootstrap(event));
   events_ | is(Location::tag) | $$(add_location(event->gen_time(), event->data<Location>()));
   events_ | is(Register::tag) | $$(on_register(event->trigger_time(), event->data<Register>()));
   events_ | is(Deregister::tag) | $$(on_deregister(event));
@@ -171,7 +173,7 @@ void apprentice::react() {
                                                     })) |
                                first();
 
-    self_register_event | rx::timeout(seconds(60), observe_on_new_thread()) |
+    self_register_event | rx::timeout(seconds(60), observe_on_aux_thread()) |
         $(
             [&](const event_ptr &event) {
               // this subscriber will quit when register is done, no worry for performance.
@@ -230,6 +232,12 @@ void apprentice::on_react() {}
 
 void apprentice::on_start() {}
 
+void apprentice::on_bootstrap(const event_ptr &event) {
+  for (const auto &record : bootstrap_snapshot::unpack(event)) {
+    schedule_event(record);
+  }
+}
+
 void apprentice::on_register(int64_t trigger_time, const Register &register_data) {
   register_location(trigger_time, register_data);
 }
@@ -287,6 +295,7 @@ void apprentice::checkin() {
   data["pid"] = GETPID();
   data["checkin_time"] = now;
   data["last_active_time"] = now;
+  data["placement"] = get_thread_placement();
   request["data"] = data;
 
   get_io_device()->get_publisher()->publish(request.dump(), 0);
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <kungfu/yijinjing/practice/bootstrap.h>
+
+using namespace kungfu::longfist::types;
+using namespace kungfu::yijinjing::journal;
+
+namespace kungfu::yijinjing::practice {
+static constexpr size_t RECORD_ALIGNMENT = 8;
+
+static size_t align_record(size_t length) { return (length + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1); }
+
+/**
+ * A record of a Bootstrap frame, holds the chunk it points into so that it stays valid after the reader moves on.
+ */
+struct bootstrap_record : event {
+  bootstrap_record(const event_ptr &bootstrap, std::shared_ptr<const std::string> chunk, size_t offset,
+                   int32_t msg_type, uint32_t length)
+      : gen_time_(bootstrap->gen_time()), trigger_time_(bootstrap->trigger_time()), source_(bootstrap->source()),
+        dest_(bootstrap->dest()), chunk_(std::move(chunk)), offset_(offset), msg_type_(msg_type), length_(length) {}
+
+  [[nodiscard]] int64_t gen_time() const override { return gen_time_; }
+
+  [[nodiscard]] int64_t trigger_time() const override { return trigger_time_; }
+
+  [[nodiscard]] int32_t msg_type() const override { return msg_type_; }
+
+  [[nodiscard]] uint32_t source() const override { return source_; }
+
+  [[nodiscard]] uint32_t dest() const override { return dest_; }
+
+  [[nodiscard]] uint32_t data_length() const override { return length_; }
+
+  [[nodiscard]] const void *data_address() const override { return chunk_->data() + offset_; }
+
+  [[nodiscard]] const char *data_as_bytes() const override { return chunk_->data() + offset_; }
+
+  [[nodiscard]] std::string data_as_string() const override { return std::string(data_as_bytes(), length_); }
+
+  [[nodiscard]] std::string to_string() const override { return data_as_string(); }
+
+private:
+  const int64_t gen_time_;
+  const int64_t trigger_time_;
+  const uint32_t source_;
+  const uint32_t dest_;
+  const std::shared_ptr<const std::string> chunk_;
+  const size_t offset_;
+  const int32_t msg_type_;
+  const uint32_t length_;
+};
+
+void bootstrap_snapshot::clear() {
+  chunks_.clear();
+  size_ = 0;
+}
+
+size_t bootstrap_snapshot::size() const { return size_; }
+
+void bootstrap_snapshot::append(int32_t msg_type, const void *data, uint32_t length) {
+  auto record_length = align_record(sizeof(record_header) + length);
+  if (chunks_.empty() or (not chunks_.back().empty() and chunks_.back().length() + record_length > CHUNK_SIZE)) {
+    chunks_.emplace_back();
+    chunks_.back().reserve(std::max<size_t>(CHUNK_SIZE, record_length));
+  }
+  auto &chunk = chunks_.back();
+  record_header header = {msg_type, length};
+  chunk.append(reinterpret_cast<const char *>(&header), sizeof(record_header));
+  chunk.append(reinterpret_cast<const char *>(data), length);
+  chunk.resize(chunk.length() + record_length - sizeof(record_header) - length, '\0');
+  size_++;
+}
+
+void bootstrap_snapshot::write(int64_t trigger_time, const writer_ptr &writer) const {
+  for (const auto &chunk : chunks_) {
+    writer->write_raw(trigger_time, Bootstrap::tag, reinterpret_cast<uintptr_t>(chunk.data()), chunk.length());
+  }
+}
+
+std::vector<event_ptr> bootstrap_snapshot::unpack(const event_ptr &event) {
+  auto chunk = std::make_shared<const std::string>(event->data_as_bytes(), event->data_length());
+  std::vector<event_ptr> records = {};
+  size_t offset = 0;
+  while (offset + sizeof(record_header) <= chunk->length()) {
+    record_header header = {};
+    memcpy(&header, chunk->data() + offset, sizeof(record_header));
+    auto data_offset = offset + sizeof(record_header);
+    if (data_offset + header.length > chunk->length()) {
+      SPDLOG_ERROR("corrupted bootstrap record of msg type {} at {}", header.msg_type, offset);
+      break;
+    }
+    records.push_back(std::make_shared<bootstrap_record>(event, chunk, data_offset, header.msg_type, header.length));
+    offset = align_record(data_offset + header.length);
+  }
+  return records;
+}
+} // namespace kungfu::yijinjing::practice
@@ -42,6 +42,7 @@ hero::hero(io_device_ptr io_device)
   add_location(0, cached_home_location_);
   add_location(0, ledger_home_location_);
   reader_ = io_device_->open_reader_to_subscribe();
+  profiler_ = dispatch_profiler::from_env(get_locator());
 }
 
 hero::~hero() {
@@ -68,9 +69,11 @@ void hero::step() {
 void hero::run() {
   SPDLOG_INFO("[{:08x}] {} running", get_home_uid(), get_home_uname());
   SPDLOG_TRACE("from {} until {}", time::strftime(begin_time_), time::strftime(end_time_));
+  place_threads();
   setup();
   continual_ = true;
   events_.connect(cs_);
+  dump_profile();
   on_exit();
   SPDLOG_INFO("[{:08x}] {} done", get_home_uid(), get_home_uname());
 }
@@ -192,6 +195,13 @@ location_ptr hero::get_cached_home_location() const { return cached_home_locatio
 
 const rx::connectable_observable<event_ptr> &hero::get_events() const { return events_; }
 
+bool hero::request_profile_dump() {
+  if (profiler_) {
+    profiler_->request_dump();
+  }
+  return bool(profiler_);
+}
+
 uint64_t hero::make_source_dest_hash(uint32_t source_id, uint32_t dest_id) {
   return uint64_t(source_id) << 32u | uint64_t(dest_id);
 }
@@ -223,18 +233,27 @@ bool hero::check_location_live(uint32_t source_id, uint32_t dest_id) const {
   return true;
 }
 
-void hero::add_location(int64_t, const location_ptr &location) { locations_.try_emplace(location->uid, location); }
+void hero::add_location(int64_t, const location_ptr &location) {
+  if (locations_.try_emplace(location->uid, location).second) {
+    registry_version_++;
+  }
+}
 
 void hero::add_location(int64_t trigger_time, const Location &location) {
   add_location(trigger_time, data::location::make_shared(location, get_locator()));
 }
 
-void hero::remove_location(int64_t trigger_time, uint32_t location_uid) { locations_.erase(location_uid); }
+void hero::remove_location(int64_t trigger_time, uint32_t location_uid) {
+  if (locations_.erase(location_uid)) {
+    registry_version_++;
+  }
+}
 
 void hero::register_location(int64_t, const Register &register_data) {
   uint32_t location_uid = register_data.location_uid;
   auto result = registry_.try_emplace(location_uid, register_data);
   if (result.second) {
+    registry_version_++;
     SPDLOG_TRACE("location [{:08x}] {} up", location_uid, get_location_uname(location_uid));
   }
 }
@@ -242,6 +261,7 @@ void hero::register_location(int64_t, const Register &register_data) {
 void hero::deregister_location(int64_t, const uint32_t location_uid) {
   auto result = registry_.erase(location_uid);
   if (result) {
+    registry_version_++;
     SPDLOG_TRACE("location [{:08x}] {} down", location_uid, get_location_uname(location_uid));
   }
 }
@@ -250,6 +270,7 @@ void hero::register_channel(int64_t, const Channel &channel) {
   [[maybe_unused]] uint64_t channel_uid = make_source_dest_hash(channel.source_id, channel.dest_id);
   auto result = channels_.try_emplace(channel_uid, channel);
   if (result.second) {
+    registry_version_++;
     auto source_uname = get_location_uname(channel.source_id);
     auto dest_uname = get_location_uname(channel.dest_id);
     SPDLOG_TRACE("channel [{:08x}] {} -> {} up", channel_uid, source_uname, dest_uname);
@@ -266,6 +287,7 @@ void hero::deregister_channel(uint32_t source_id) {
       auto dest_uname = get_location_uname(channel.dest_id);
       SPDLOG_TRACE("channel [{:08x}] {} -> {} down", channel_uid, source_uname, dest_uname);
       channel_it = channels_.erase(channel_it);
+      registry_version_++;
       continue;
     }
     channel_it++;
@@ -276,6 +298,7 @@ void hero::register_band(int64_t, const Band &band) {
   uint64_t band_uid = make_source_dest_hash(band.source_id, band.dest_id);
   auto result = bands_.try_emplace(band_uid, band);
   if (result.second) {
+    registry_version_++;
     auto source_uname = get_location_uname(band.source_id);
     auto dest_uname = get_location_uname(band.dest_id);
     SPDLOG_TRACE("band [{:08x}] {} -> {} up", band_uid, source_uname, dest_uname);
@@ -292,6 +315,7 @@ void hero::deregister_band(uint32_t source_id) {
       auto dest_uname = get_location_uname(band.dest_id);
       SPDLOG_TRACE("band [{:08x}] {} -> {} down", band_uid, source_uname, dest_uname);
       band_it = bands_.erase(band_it);
+      registry_version_++;
       continue;
     }
     band_it++;
@@ -328,11 +352,16 @@ void hero::require_write_to_band(int64_t trigger_time, uint32_t source_id,
   writer->write(trigger_time, msg);
 }
 
+void hero::schedule_event(const event_ptr &event) { scheduled_events_.push_back(event); }
+
 void hero::produce(const rx::subscriber<event_ptr> &sb) {
   try {
     do {
       live_ = drain(sb) && live_;
       on_active();
+      if (profiler_ and profiler_->is_due(time::now_in_nano())) {
+        dump_profile();
+      }
     } while (continual_ and live_);
   } catch (...) {
     live_ = false;
@@ -349,6 +378,7 @@ bool hero::drain(const rx::subscriber<event_ptr> &sb) {
     now_ = time::now_in_nano();
     if (notice.length() > 2) {
       sb.on_next(std::make_shared<nanomsg_json>(notice));
+      dispatch_scheduled(sb);
     } else {
       on_notify();
     }
@@ -359,7 +389,12 @@ bool hero::drain(const rx::subscriber<event_ptr> &sb) {
       if (frame_time > now_) {
         now_ = frame_time;
       }
-      sb.on_next(reader_->current_frame());
+      if (profiler_) {
+        dispatch_profiled(sb);
+      } else {
+        sb.on_next(reader_->current_frame());
+      }
+      dispatch_scheduled(sb);
       on_frame();
       reader_->next();
     } else {
@@ -374,6 +409,47 @@ bool hero::drain(const rx::subscriber<event_ptr> &sb) {
   return true;
 }
 
+void hero::dispatch_profiled(const rx::subscriber<event_ptr> &sb) {
+  const auto &frame = reader_->current_frame();
+  auto msg_type = frame->msg_type();
+  auto gen_time = frame->gen_time();
+  auto dispatch_time = time::now_in_nano();
+  sb.on_next(frame);
+  profiler_->record(msg_type, dispatch_time - gen_time, time::now_in_nano() - dispatch_time);
+}
+
+void hero::dispatch_scheduled(const rx::subscriber<event_ptr> &sb) {
+  while (live_ and not scheduled_events_.empty()) {
+    auto event = scheduled_events_.front();
+    scheduled_events_.pop_front();
+    sb.on_next(event);
+  }
+}
+
+const std::string &hero::get_thread_placement() const { return thread_placement_; }
+
+uint64_t hero::get_registry_version() const { return registry_version_; }
+
+void hero::place_threads() {
+  auto locator = get_locator();
+  auto get_env = [&](const char *name) { return locator->has_env(name) ? locator->get_env(name) : std::string{}; };
+  os::thread_placement placement = {};
+  placement.cpus = os::parse_cpu_list(get_env(CPU_AFFINITY_ENV));
+  placement.aux_cpus = os::parse_cpu_list(get_env(AUX_CPU_AFFINITY_ENV));
+  placement.rt_priority = std::atoi(get_env(RT_PRIORITY_ENV).c_str());
+  placement.mlock = get_env(MLOCK_ENV) == "on" or get_env(MLOCK_ENV) == "true";
+  thread_placement_ = os::apply_thread_placement(placement);
+  if (not thread_placement_.empty()) {
+    SPDLOG_INFO("[{:08x}] {} thread placement {}", get_home_uid(), get_home_uname(), thread_placement_);
+  }
+}
+
+void hero::dump_profile() {
+  if (profiler_) {
+    profiler_->dump(time::now_in_nano(), get_home_uname());
+  }
+}
+
 void hero::delegate_produce(hero *instance, const rx::subscriber<event_ptr> &subscriber) {
 #ifdef _WINDOWS
   __try {
@@ -134,10 +134,9 @@ void master::register_app(const event_ptr &event) {
   write_time_reset(event->gen_time(), app_cmd_writer);
   write_trading_day(event->gen_time(), app_cmd_writer);
 
-  // tell others alive locations
-  write_locations(event->gen_time(), app_cmd_writer);
-  // tell the registing app the their self and cached process started
-  write_registries(event->gen_time(), app_cmd_writer);
+  // tell the registering app alive locations, its own register and whether cached process started
+  update_register_bootstrap();
+  register_bootstrap_.write(event->gen_time(), app_cmd_writer);
 
   on_register(event, register_data);
 }
@@ -331,10 +330,8 @@ void master::on_request_cached_done(const event_ptr &event) {
   if (has_writer(app_uid)) {
     auto app_cmd_writer = get_writer(app_uid);
     app_cmd_writer->mark(now(), RequestStart::tag);
-    write_locations(event->gen_time(), app_cmd_writer);
-    write_registries(event->gen_time(), app_cmd_writer);
-    write_channels(event->gen_time(), app_cmd_writer);
-    write_bands(event->gen_time(), app_cmd_writer);
+    update_start_bootstrap();
+    start_bootstrap_.write(event->gen_time(), app_cmd_writer);
   } else {
     SPDLOG_WARN("no writer {} {}", app_uid, get_location_uname(app_uid));
   }
@@ -383,27 +380,38 @@ void master::write_trading_day(int64_t, const writer_ptr &writer) {
   writer->close_data();
 }
 
-void master::write_registries(int64_t trigger_time, const writer_ptr &writer) {
-  for (const auto &item : registry_) {
-    writer->write(trigger_time, item.second);
+void master::update_register_bootstrap() {
+  if (register_bootstrap_version_ == get_registry_version()) {
+    return;
   }
+  register_bootstrap_version_ = get_registry_version();
+  register_bootstrap_.clear();
+  append_registry(register_bootstrap_);
+  SPDLOG_DEBUG("register bootstrap version {} of {} records", register_bootstrap_version_, register_bootstrap_.size());
 }
 
-void master::write_locations(int64_t trigger_time, const writer_ptr &writer) {
-  for (const auto &item : locations_) {
-    writer->write(trigger_time, dynamic_cast<Location &>(*item.second));
+void master::update_start_bootstrap() {
+  if (start_bootstrap_version_ == get_registry_version()) {
+    return;
   }
-}
-
-void master::write_channels(int64_t trigger_time, const writer_ptr &writer) {
+  start_bootstrap_version_ = get_registry_version();
+  start_bootstrap_.clear();
+  append_registry(start_bootstrap_);
   for (const auto &item : channels_) {
-    writer->write(trigger_time, item.second);
+    start_bootstrap_.append(item.second);
   }
+  for (const auto &item : bands_) {
+    start_bootstrap_.append(item.second);
+  }
+  SPDLOG_DEBUG("start bootstrap version {} of {} records", start_bootstrap_version_, start_bootstrap_.size());
 }
 
-void master::write_bands(int64_t trigger_time, const writer_ptr &writer) {
-  for (const auto &item : bands_) {
-    writer->write(trigger_time, item.second);
+void master::append_registry(bootstrap_snapshot &bootstrap) const {
+  for (const auto &item : locations_) {
+    bootstrap.append(dynamic_cast<Location &>(*item.second));
+  }
+  for (const auto &item : registry_) {
+    bootstrap.append(item.second);
   }
 }
 
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <kungfu/longfist/longfist.h>
+#include <kungfu/yijinjing/log.h>
+#include <kungfu/yijinjing/practice/profiler.h>
+#include <kungfu/yijinjing/time.h>
+
+using namespace kungfu::longfist;
+using namespace kungfu::yijinjing::data;
+
+namespace kungfu::yijinjing::practice {
+static constexpr int64_t DEFAULT_DUMP_INTERVAL = 60 * time_unit::NANOSECONDS_PER_SECOND;
+
+static std::string get_type_name(int32_t msg_type) {
+  std::string type_name = fmt::format("{}", msg_type);
+  boost::hana::for_each(AllTypes, [&](auto type) {
+    using DataType = typename decltype(+boost::hana::second(type))::type;
+    if (DataType::tag == msg_type) {
+      type_name = DataType::type_name.c_str();
+    }
+  });
+  return type_name;
+}
+
+dispatch_profiler_ptr dispatch_profiler::from_env(const locator_ptr &locator) {
+  if (not locator->has_env(PROFILE_DISPATCH_ENV)) {
+    return {};
+  }
+  auto value = locator->get_env(PROFILE_DISPATCH_ENV);
+  if (value == "on" or value == "true") {
+    return std::make_shared<dispatch_profiler>(DEFAULT_DUMP_INTERVAL);
+  }
+  auto seconds = std::strtoll(value.c_str(), nullptr, 10);
+  if (seconds <= 0) {
+    return {};
+  }
+  return std::make_shared<dispatch_profiler>(seconds * time_unit::NANOSECONDS_PER_SECOND);
+}
+
+dispatch_profiler::dispatch_profiler(int64_t interval)
+    : interval_(interval), window_start_(time::now_in_nano()), next_dump_time_(window_start_ + interval) {}
+
+void dispatch_profiler::dump(int64_t nanotime, const std::string &uname) {
+  dump_requested_ = false;
+  next_dump_time_ = nanotime + interval_;
+
+  std::vector<std::pair<int32_t, entry *>> sorted = {};
+  for (auto &pair : entries_) {
+    if (pair.second.duration.count() > 0) {
+      sorted.emplace_back(pair.first, &pair.second);
+    }
+  }
+  auto total = [](const entry *e) { return e->duration.mean() * e->duration.count(); };
+  std::sort(sorted.begin(), sorted.end(), [&](auto &a, auto &b) { return total(a.second) > total(b.second); });
+
+  SPDLOG_INFO("{} dispatch profile of last {:.3f}s, {} msg types, in ns", uname,
+              double(nanotime - window_start_) / time_unit::NANOSECONDS_PER_SECOND, sorted.size());
+  for (auto &pair : sorted) {
+    auto &lag = pair.second->lag;
+    auto &duration = pair.second->duration;
+    SPDLOG_INFO("{:>24} count {:>9} | handle total {:>12.0f} p50 {:>9} p99 {:>9} p999 {:>9} max {:>9} "
+                "| lag p50 {:>9} p99 {:>9} max {:>9}",
+                get_type_name(pair.first), duration.count(), total(pair.second), duration.percentile(0.5),
+                duration.percentile(0.99), duration.percentile(0.999), duration.max(), lag.percentile(0.5),
+                lag.percentile(0.99), lag.max());
+    lag.reset();
+    duration.reset();
+  }
+  window_start_ = nanotime;
+}
+} // namespace kungfu::yijinjing::practice
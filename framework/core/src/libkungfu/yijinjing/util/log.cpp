@@ -7,7 +7,11 @@
 #include <kungfu/common.h>
 #include <kungfu/yijinjing/log.h>
 #include <kungfu/yijinjing/time.h>
+#include <kungfu/yijinjing/util/os.h>
 
+#include <bit>
+#include <cctype>
+#include <cerrno>
 #include <spdlog/sinks/daily_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
@@ -24,14 +28,171 @@ public:
   }
 
   void format(const spdlog::details::log_msg &msg, spdlog::memory_buf_t &dest) override {
-    spdlog::details::fmt_helper::append_string_view(time::strftime(time::now_in_nano(), TS_PATTERN), dest);
+    // msg.time is taken on the logging thread, which keeps timestamps right when formatted by async_sink
+    int64_t nanotime = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+    int64_t second = nanotime / time_unit::NANOSECONDS_PER_SECOND;
+    if (second != cached_second_) {
+      cached_second_ = second;
+      cached_prefix_ = time::strftime(second * time_unit::NANOSECONDS_PER_SECOND, TS_SECOND_PATTERN);
+    }
+    spdlog::details::fmt_helper::append_string_view(cached_prefix_, dest);
+    spdlog::details::fmt_helper::pad9(static_cast<uint64_t>(nanotime % time_unit::NANOSECONDS_PER_SECOND), dest);
+    spdlog::details::fmt_helper::append_string_view("] ", dest);
     spdlog_formatter.format(msg, dest);
   }
 
 private:
   spdlog::pattern_formatter spdlog_formatter;
+  int64_t cached_second_ = -1;
+  std::string cached_prefix_ = {};
 };
 
+static constexpr size_t ASYNC_SLOT_PAYLOAD_RESERVE = 256;
+static constexpr auto ASYNC_IDLE_SLEEP = std::chrono::milliseconds(1);
+static constexpr auto ASYNC_DROP_REPORT_INTERVAL = std::chrono::seconds(10);
+static constexpr size_t ASYNC_QUEUE_SIZE_LIMIT = 1 << 24;
+
+async_sink::async_sink(std::vector<spdlog::sink_ptr> sinks, size_t queue_size, overflow_policy policy)
+    : sinks_(std::move(sinks)), policy_(policy), mask_(std::bit_ceil(std::max<size_t>(queue_size, 2)) - 1),
+      slots_(std::make_unique<slot[]>(mask_ + 1)) {
+  for (size_t i = 0; i <= mask_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+    slots_[i].payload.reserve(ASYNC_SLOT_PAYLOAD_RESERVE);
+  }
+  worker_ = std::thread([this]() {
+    os::place_aux_thread();
+    auto last_report = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_acquire)) {
+      drain();
+      if (std::chrono::steady_clock::now() - last_report >= ASYNC_DROP_REPORT_INTERVAL) {
+        last_report = std::chrono::steady_clock::now();
+        report_dropped();
+      }
+      std::this_thread::sleep_for(ASYNC_IDLE_SLEEP);
+    }
+    drain();
+    report_dropped();
+  });
+}
+
+async_sink::~async_sink() {
+  running_.store(false, std::memory_order_release);
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void async_sink::log(const spdlog::details::log_msg &msg) {
+  while (not try_push(msg)) {
+    if (policy_ == overflow_policy::drop) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void async_sink::flush() {
+  // wait for the worker to catch up with everything pushed so far
+  auto target = enqueue_pos_.load(std::memory_order_acquire);
+  while (dequeue_pos_.load(std::memory_order_acquire) < target and running_.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  for (auto &sink : sinks_) {
+    sink->flush();
+  }
+}
+
+void async_sink::set_pattern(const std::string &pattern) {
+  for (auto &sink : sinks_) {
+    sink->set_pattern(pattern);
+  }
+}
+
+void async_sink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+  for (auto &sink : sinks_) {
+    sink->set_formatter(sink_formatter->clone());
+  }
+}
+
+uint64_t async_sink::get_dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+
+bool async_sink::try_push(const spdlog::details::log_msg &msg) {
+  auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    auto &s = slots_[pos & mask_];
+    auto diff = static_cast<intptr_t>(s.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+    if (diff < 0) {
+      return false;
+    }
+    if (diff > 0) {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+      s.level = msg.level;
+      s.time = msg.time;
+      s.thread_id = msg.thread_id;
+      s.line = msg.source.line;
+      s.logger_name.assign(msg.logger_name.data(), msg.logger_name.size());
+      s.filename.assign(msg.source.filename == nullptr ? "" : msg.source.filename);
+      s.funcname.assign(msg.source.funcname == nullptr ? "" : msg.source.funcname);
+      s.payload.assign(msg.payload.data(), msg.payload.size());
+      s.sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+  }
+}
+
+bool async_sink::try_pop() {
+  auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+  auto &s = slots_[pos & mask_];
+  if (static_cast<intptr_t>(s.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1) < 0) {
+    return false;
+  }
+  spdlog::source_loc source(s.filename.c_str(), s.line, s.funcname.c_str());
+  spdlog::details::log_msg msg(s.time, source, s.logger_name, s.level, s.payload);
+  msg.thread_id = s.thread_id;
+  for (auto &sink : sinks_) {
+    if (sink->should_log(msg.level)) {
+      sink->log(msg);
+    }
+  }
+  s.sequence.store(pos + mask_ + 1, std::memory_order_release);
+  dequeue_pos_.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+void async_sink::report_dropped() {
+  auto dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped == reported_dropped_) {
+    return;
+  }
+  auto payload = fmt::format("async log queue full, dropped {} messages, {} in total", dropped - reported_dropped_,
+                             dropped);
+  reported_dropped_ = dropped;
+  spdlog::details::log_msg msg(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, "", spdlog::level::warn,
+                               payload);
+  for (auto &sink : sinks_) {
+    if (sink->should_log(msg.level)) {
+      sink->log(msg);
+    }
+    sink->flush();
+  }
+}
+
+void async_sink::drain() {
+  bool written = false;
+  while (try_pop()) {
+    written = true;
+  }
+  if (written) {
+    for (auto &sink : sinks_) {
+      sink->flush();
+    }
+  }
+}
+
 class emitable_logger : public spdlog::logger {
 public:
   emitable_logger(std::string name, spdlog::sink_ptr single_sink)
@@ -39,6 +200,9 @@ public:
 
   emitable_logger(std::string name, spdlog::sinks_init_list sinks) : spdlog::logger(std::move(name), sinks) {}
 
+  template <typename It>
+  emitable_logger(std::string name, It begin, It end) : spdlog::logger(std::move(name), begin, end) {}
+
   explicit emitable_logger(const logger &other) : spdlog::logger(other) {}
 
   std::shared_ptr<logger> clone(std::string logger_name) override {
@@ -60,6 +224,31 @@ spdlog::level::level_enum get_env_log_level(const data::locator_ptr &locator) {
   return spdlog::level::from_str(level_name);
 }
 
+overflow_policy get_env_log_overflow_policy(const data::locator_ptr &locator) {
+  auto policy_name = locator->has_env(LOG_OVERFLOW_ENV) ? locator->get_env(LOG_OVERFLOW_ENV) : "block";
+  return policy_name == "drop" ? overflow_policy::drop : overflow_policy::block;
+}
+
+static bool parse_async_queue_size(const std::string &text, size_t &size) {
+  char *end = nullptr;
+  errno = 0;
+  auto value = std::strtoull(text.c_str(), &end, 10);
+  if (text.empty() or not std::isdigit(text.front()) or *end != '\0' or errno == ERANGE or
+      value > ASYNC_QUEUE_SIZE_LIMIT) {
+    return false;
+  }
+  size = value;
+  return true;
+}
+
+size_t get_env_log_async_queue_size(const data::locator_ptr &locator) {
+  size_t size = 0;
+  if (locator->has_env(LOG_ASYNC_QUEUE_ENV)) {
+    parse_async_queue_size(locator->get_env(LOG_ASYNC_QUEUE_ENV), size);
+  }
+  return size;
+}
+
 std::shared_ptr<spdlog::logger> get_main_logger() { return spdlog::default_logger(); }
 
 const std::string &setup_log(const data::location_ptr &location, const std::string &name) {
@@ -68,19 +257,34 @@ const std::string &setup_log(const data::location_ptr &location, const std::stri
     std::string log_file = location->locator->layout_file(location, longfist::enums::layout::LOG, name);
     auto daily_sink = std::make_shared<spdlog::sinks::daily_file_sink_mt>(log_file, 0, 0);
 
+    std::vector<spdlog::sink_ptr> log_sinks = {daily_sink};
     if (location->group != "node") {
-      auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-      spdlog::sinks_init_list log_sinks = {console_sink, daily_sink};
-      logger = std::make_shared<emitable_logger>(name, log_sinks);
+      log_sinks.insert(log_sinks.begin(), std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+    }
+
+    auto async_queue_size = get_env_log_async_queue_size(location->locator);
+    if (async_queue_size > 0) {
+      auto overflow = get_env_log_overflow_policy(location->locator);
+      auto sink = std::make_shared<async_sink>(log_sinks, async_queue_size, overflow);
+      logger = std::make_shared<emitable_logger>(name, sink);
     } else {
-      logger = std::make_shared<emitable_logger>(name, daily_sink);
+      logger = std::make_shared<emitable_logger>(name, log_sinks.begin(), log_sinks.end());
     }
 
     logger->set_formatter(spdlog::details::make_unique<pattern_formatter>());
     logger->set_level(get_env_log_level(location->locator));
-    logger->flush_on(spdlog::level::trace);
+    // async sink flushes by itself once its queue drains, flushing per message would block the calling thread
+    logger->flush_on(async_queue_size > 0 ? spdlog::level::off : spdlog::level::trace);
 
     spdlog::set_default_logger(std::static_pointer_cast<spdlog::logger>(logger));
+
+    size_t parsed_size = 0;
+    auto locator = location->locator;
+    if (locator->has_env(LOG_ASYNC_QUEUE_ENV) and
+        not parse_async_queue_size(locator->get_env(LOG_ASYNC_QUEUE_ENV), parsed_size)) {
+      SPDLOG_WARN("invalid {} [{}], expects a queue size up to {}, logs synchronously", LOG_ASYNC_QUEUE_ENV,
+                  locator->get_env(LOG_ASYNC_QUEUE_ENV), ASYNC_QUEUE_SIZE_LIMIT);
+    }
   } else {
     SPDLOG_WARN("Setup log for {} more than once", name);
   }
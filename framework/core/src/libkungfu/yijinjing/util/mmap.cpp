@@ -96,6 +96,47 @@ uintptr_t load_mmap_buffer(const std::string &path, size_t size, bool is_writing
   return reinterpret_cast<uintptr_t>(buffer);
 }
 
+uintptr_t prefault_mmap_buffer(const std::string &path, size_t size, bool lazy) {
+#ifdef _WINDOWS
+  return 0;
+#else
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, (mode_t)0600);
+  if (fd < 0) {
+    return 0;
+  }
+
+#ifdef __linux__
+  // allocate disk blocks up front, falls back to a sparse file if the file system does not support it
+  bool stretched = posix_fallocate(fd, 0, size) == 0 or ftruncate(fd, size) == 0;
+#else
+  bool stretched = ftruncate(fd, size) == 0;
+#endif
+  if (not stretched) {
+    close(fd);
+    return 0;
+  }
+
+  void *buffer = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (buffer == MAP_FAILED) {
+    return 0;
+  }
+
+  // shared mappings are populated read only, write to each memory page so that later writes do not fault
+  auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto memory = static_cast<volatile char *>(buffer);
+  for (size_t offset = 0; offset < size; offset += page_size) {
+    memory[offset] = 0;
+  }
+
+  if (!lazy && madvise(buffer, size, MADV_RANDOM) != 0 && mlock(buffer, size) != 0) {
+    munmap(buffer, size);
+    return 0;
+  }
+  return reinterpret_cast<uintptr_t>(buffer);
+#endif // _WINDOWS
+}
+
 bool release_mmap_buffer(uintptr_t address, [[maybe_unused]] size_t size, bool lazy) {
   void *buffer = reinterpret_cast<void *>(address);
 #ifdef _WINDOWS
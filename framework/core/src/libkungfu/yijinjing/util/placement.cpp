@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif // __linux__
+
+#include <atomic>
+#include <mutex>
+
+#include <kungfu/common.h>
+#include <kungfu/yijinjing/util/os.h>
+
+namespace kungfu::yijinjing::os {
+static std::mutex aux_cpus_mutex_ = {};
+static std::vector<int> aux_cpus_ = {};
+static std::atomic<bool> memory_locked_ = false;
+
+static void set_aux_cpus(const std::vector<int> &cpus) {
+  std::lock_guard<std::mutex> lock(aux_cpus_mutex_);
+  aux_cpus_ = cpus;
+}
+
+static std::vector<int> get_aux_cpus() {
+  std::lock_guard<std::mutex> lock(aux_cpus_mutex_);
+  return aux_cpus_;
+}
+
+std::vector<int> parse_cpu_list(const std::string &text) {
+  std::vector<int> cpus = {};
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    try {
+      auto dash = item.find('-');
+      int first = std::stoi(item.substr(0, dash));
+      int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+      for (int cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::exception &) {
+      SPDLOG_WARN("invalid cpu list item [{}] of [{}]", item, text);
+    }
+  }
+  return cpus;
+}
+
+#ifdef __linux__
+static bool set_affinity(pid_t tid, const std::vector<int> &cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 and cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return sched_setaffinity(tid, sizeof(set), &set) == 0;
+}
+
+static std::vector<int> get_affinity(pid_t tid) {
+  std::vector<int> cpus = {};
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(tid, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+std::string apply_thread_placement(const thread_placement &placement) {
+  if (placement.cpus.empty() and placement.aux_cpus.empty() and placement.rt_priority <= 0 and not placement.mlock) {
+    return {};
+  }
+  auto self = static_cast<pid_t>(syscall(SYS_gettid));
+
+  set_aux_cpus(placement.aux_cpus);
+  if (not placement.aux_cpus.empty()) {
+    std::error_code ec;
+    for (auto &task : std::filesystem::directory_iterator("/proc/self/task", ec)) {
+      auto tid = static_cast<pid_t>(std::strtol(task.path().filename().c_str(), nullptr, 10));
+      if (tid > 0 and tid != self and not set_affinity(tid, placement.aux_cpus)) {
+        SPDLOG_WARN("failed to pin thread {} to aux cpus: {}", tid, std::strerror(errno));
+      }
+    }
+  }
+
+  if (not placement.cpus.empty() and not set_affinity(0, placement.cpus)) {
+    SPDLOG_WARN("failed to pin main thread to cpus: {}", std::strerror(errno));
+  }
+
+  if (placement.rt_priority > 0) {
+    sched_param param = {};
+    param.sched_priority = std::clamp(placement.rt_priority, sched_get_priority_min(SCHED_FIFO),
+                                      sched_get_priority_max(SCHED_FIFO));
+    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+      SPDLOG_WARN("failed to set SCHED_FIFO priority {}: {}", param.sched_priority, std::strerror(errno));
+    }
+  }
+
+  // MCL_FUTURE is left out on purpose, it would lock every journal page mapped later, including pages of readers,
+  // and fail those mappings once RLIMIT_MEMLOCK is reached, only pages for writing are locked later on
+  bool locked = false;
+  if (placement.mlock) {
+    rlimit limit = {};
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 and limit.rlim_cur < limit.rlim_max) {
+      limit.rlim_cur = limit.rlim_max;
+      setrlimit(RLIMIT_MEMLOCK, &limit);
+    }
+    locked = mlockall(MCL_CURRENT) == 0;
+    if (not locked) {
+      SPDLOG_WARN("failed to lock memory, RLIMIT_MEMLOCK {}: {}", limit.rlim_cur, std::strerror(errno));
+    }
+  }
+  memory_locked_ = locked;
+
+  sched_param param = {};
+  auto policy = sched_getscheduler(0);
+  sched_getparam(0, &param);
+
+  nlohmann::json effective = {};
+  effective["cpus"] = get_affinity(0);
+  effective["aux_cpus"] = placement.aux_cpus;
+  effective["policy"] = policy == SCHED_FIFO ? "fifo" : policy == SCHED_RR ? "rr" : "other";
+  effective["priority"] = param.sched_priority;
+  effective["mlock"] = locked;
+  return effective.dump();
+}
+
+void place_aux_thread() {
+  auto aux_cpus = get_aux_cpus();
+  if (not aux_cpus.empty() and not set_affinity(0, aux_cpus)) {
+    SPDLOG_WARN("failed to pin thread to aux cpus: {}", std::strerror(errno));
+  }
+}
+
+void lock_placed_memory(uintptr_t address, size_t size) {
+  if (memory_locked_ and mlock(reinterpret_cast<void *>(address), size) != 0) {
+    SPDLOG_WARN("failed to lock {} bytes of memory: {}", size, std::strerror(errno));
+  }
+}
+#else
+std::string apply_thread_placement(const thread_placement &placement) {
+  if (not placement.cpus.empty() or not placement.aux_cpus.empty() or placement.rt_priority > 0 or placement.mlock) {
+    SPDLOG_WARN("thread placement is only supported on linux, ignored");
+  }
+  return {};
+}
+
+void place_aux_thread() {}
+
+void lock_placed_memory([[maybe_unused]] uintptr_t address, [[maybe_unused]] size_t size) {}
+#endif // __linux__
+} // namespace kungfu::yijinjing::os
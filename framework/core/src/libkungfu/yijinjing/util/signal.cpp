@@ -85,8 +85,12 @@ void kf_os_signal_handler(int signum) {
     SPDLOG_CRITICAL("kungfu app terminated by signal {}", signum);
     print_stack_trace();
     exit_hero(signum);
+  case SIGUSR2: // terminate process    User defined signal 2, dumps dispatch profile instead if profiling
+    if (hero_instance != nullptr and hero_instance->request_profile_dump()) {
+      break;
+    }
+    [[fallthrough]];
   case SIGUSR1: // terminate process    User defined signal 1
-  case SIGUSR2: // terminate process    User defined signal 2
     SPDLOG_CRITICAL("kungfu app caught user defined signal {}", signum);
     print_stack_trace();
     exit_hero(signum);
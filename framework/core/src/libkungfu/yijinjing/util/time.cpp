@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <ctime>
 #include <fmt/format.h>
 #include <regex>
@@ -8,6 +11,12 @@
 #include <kungfu/common.h>
 #include <kungfu/yijinjing/time.h>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define KUNGFU_HAS_TSC_CLOCK
+#endif
+
 using namespace std::chrono;
 
 namespace kungfu::yijinjing {
@@ -38,11 +47,183 @@ inline int64_t steady_clock_count() { return NOW_SINCE_EPOCH(steady_clock).count
 
 #endif
 
+#ifdef KUNGFU_HAS_TSC_CLOCK
+
+/**
+ * Converts invariant tsc cycles to steady clock nano seconds.
+ * The ratio is measured at startup against CLOCK_MONOTONIC and refined every TSC_RESYNC_INTERVAL by measuring again
+ * over the whole time since startup, so drift between the two clocks never accumulates beyond one interval.
+ * A resync never steps the mapping: the new one starts at the value of the old one at the resync point, and the
+ * error against CLOCK_MONOTONIC is slewed away over the next interval by the ratio, bounded by TSC_MAX_SLEW.
+ * Results are clamped to the largest one returned so far, so that they never go backwards across cores either.
+ * Readers take the conversion parameters through a seqlock, they never block on a resync.
+ */
+class tsc_clock {
+public:
+  static constexpr int64_t TSC_CALIBRATE_DURATION = 10 * time_unit::NANOSECONDS_PER_MILLISECOND;
+  static constexpr int64_t TSC_RESYNC_INTERVAL = time_unit::NANOSECONDS_PER_SECOND;
+  static constexpr int64_t TSC_MAX_SLEW = TSC_RESYNC_INTERVAL / 10;
+  static constexpr int TSC_MULT_SHIFT = 32;
+
+  static bool is_supported() {
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 or eax < 0x80000007) {
+      return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return edx & (1u << 8u);
+  }
+
+  static tsc_clock &get_instance() {
+    static tsc_clock instance = {};
+    return instance;
+  }
+
+  int64_t steady_clock_count() {
+    while (true) {
+      auto seq = seq_.load(std::memory_order_acquire);
+      if (seq & 1u) {
+        continue;
+      }
+      auto base_tsc = base_tsc_.load(std::memory_order_relaxed);
+      auto base_nano = base_nano_.load(std::memory_order_relaxed);
+      auto mult = mult_.load(std::memory_order_relaxed);
+      auto tsc = int64_t(__rdtsc());
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) != seq) {
+        continue;
+      }
+      auto cycles = tsc - base_tsc;
+      if (cycles > resync_cycles_.load(std::memory_order_relaxed) and resync()) {
+        continue;
+      }
+      auto nano = base_nano + int64_t((__int128(cycles) * mult) >> TSC_MULT_SHIFT);
+      auto last = last_nano_.load(std::memory_order_relaxed);
+      while (nano > last and not last_nano_.compare_exchange_weak(last, nano, std::memory_order_relaxed)) {
+      }
+      return std::max(nano, last);
+    }
+  }
+
+private:
+  std::atomic<uint32_t> seq_ = 0;
+  std::atomic<int64_t> base_tsc_ = 0;
+  std::atomic<int64_t> base_nano_ = 0;
+  std::atomic<uint64_t> mult_ = 0;
+  std::atomic_flag resyncing_ = ATOMIC_FLAG_INIT;
+  int64_t origin_tsc_ = 0;
+  int64_t origin_nano_ = 0;
+  std::atomic<int64_t> resync_cycles_ = INT64_MAX;
+  std::atomic<int64_t> last_nano_ = 0;
+
+  tsc_clock() {
+    sample(origin_tsc_, origin_nano_);
+    int64_t tsc = 0, nano = 0;
+    do {
+      sample(tsc, nano);
+    } while (nano - origin_nano_ < TSC_CALIBRATE_DURATION);
+    update(tsc, nano);
+  }
+
+  /**
+   * Reads tsc and CLOCK_MONOTONIC as close together as possible, tsc is taken as the midpoint of the tightest window.
+   */
+  static void sample(int64_t &tsc, int64_t &nano) {
+    int64_t best_window = INT64_MAX;
+    for (int i = 0; i < 5; i++) {
+      auto before = int64_t(__rdtsc());
+      auto steady = kungfu::yijinjing::steady_clock_count();
+      auto after = int64_t(__rdtsc());
+      if (after - before < best_window) {
+        best_window = after - before;
+        tsc = before + (after - before) / 2;
+        nano = steady;
+      }
+    }
+  }
+
+  bool resync() {
+    if (resyncing_.test_and_set(std::memory_order_acquire)) {
+      return false;
+    }
+    int64_t tsc = 0, nano = 0;
+    sample(tsc, nano);
+    update(tsc, nano);
+    resyncing_.clear(std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Starts a new mapping at tsc. The first one starts at nano with the measured ratio. Later ones start where the
+   * old one is at tsc, with the ratio adjusted to catch up the error against nano by the end of the next interval.
+   * Only a mapping behind by more than TSC_MAX_SLEW, e.g. after the machine resumed, steps forward to nano.
+   */
+  void update(int64_t tsc, int64_t nano) {
+    auto rate = uint64_t((__int128(nano - origin_nano_) << TSC_MULT_SHIFT) / (tsc - origin_tsc_));
+    auto interval_cycles = int64_t((__int128(TSC_RESYNC_INTERVAL) << TSC_MULT_SHIFT) / rate);
+    auto base_nano = nano;
+    auto mult = rate;
+    auto old_mult = mult_.load(std::memory_order_relaxed);
+    if (old_mult > 0) {
+      auto old_base_tsc = base_tsc_.load(std::memory_order_relaxed);
+      auto old_base_nano = base_nano_.load(std::memory_order_relaxed);
+      auto mapped = old_base_nano + int64_t((__int128(tsc - old_base_tsc) * old_mult) >> TSC_MULT_SHIFT);
+      auto error = nano - mapped;
+      if (error <= TSC_MAX_SLEW) {
+        auto slew = std::max(error, -TSC_MAX_SLEW);
+        base_nano = mapped;
+        mult = uint64_t((__int128(TSC_RESYNC_INTERVAL + slew) << TSC_MULT_SHIFT) / interval_cycles);
+      }
+    }
+    seq_.fetch_add(1, std::memory_order_acq_rel);
+    base_tsc_.store(tsc, std::memory_order_relaxed);
+    base_nano_.store(base_nano, std::memory_order_relaxed);
+    mult_.store(mult, std::memory_order_relaxed);
+    seq_.fetch_add(1, std::memory_order_release);
+    resync_cycles_.store(interval_cycles, std::memory_order_relaxed);
+  }
+};
+
+static std::atomic<bool> tsc_clock_enabled = false;
+
+int64_t time::now_in_nano() {
+  const auto &base = get_instance().base_;
+  auto steady = tsc_clock_enabled.load(std::memory_order_relaxed) ? tsc_clock::get_instance().steady_clock_count()
+                                                                   : steady_clock_count();
+  return base.system_clock_count + steady - base.steady_clock_count;
+}
+
+bool time::set_clock_source(clock_source source) {
+  auto use_tsc = source == clock_source::tsc and is_tsc_supported();
+  if (use_tsc) {
+    tsc_clock::get_instance();
+  }
+  tsc_clock_enabled = use_tsc;
+  return get_clock_source() == source;
+}
+
+clock_source time::get_clock_source() { return tsc_clock_enabled ? clock_source::tsc : clock_source::steady; }
+
+bool time::is_tsc_supported() {
+  static bool supported = tsc_clock::is_supported();
+  return supported;
+}
+
+#else
+
 int64_t time::now_in_nano() {
   auto duration = steady_clock_count() - get_instance().base_.steady_clock_count;
   return get_instance().base_.system_clock_count + duration;
 }
 
+bool time::set_clock_source(clock_source source) { return source == clock_source::steady; }
+
+clock_source time::get_clock_source() { return clock_source::steady; }
+
+bool time::is_tsc_supported() { return false; }
+
+#endif
+
 uint32_t time::nano_hashed(int64_t nano_time) {
   return kungfu::hash_32((const unsigned char *)&nano_time, sizeof(nano_time));
 }
@@ -66,7 +247,107 @@ int64_t time::calendar_day_start(int64_t nanotime) {
 
 int64_t time::today_start() { return calendar_day_start(time::now_in_nano()); }
 
-int64_t time::strptime(const std::string &time_string, const std::string &format) {
+/**
+ * Broken down local time, filled by the hand written parser and formatter for the fields kungfu formats use.
+ */
+struct civil_time {
+  int64_t year = 1900;
+  int64_t month = 1;
+  int64_t day = 1;
+  int64_t hour = 0;
+  int64_t minute = 0;
+  int64_t second = 0;
+  int64_t nano = 0;
+};
+
+static bool parse_digits(const char *&p, const char *end, int width, int64_t &value) {
+  if (end - p < width) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < width; i++, p++) {
+    if (*p < '0' or *p > '9') {
+      return false;
+    }
+    value = value * 10 + (*p - '0');
+  }
+  return true;
+}
+
+/**
+ * Parses fixed width %Y %m %d %H %M %S %N and their compositions %F %T, any other directive is left to the slow path.
+ */
+static bool parse_fields(const char *&p, const char *end, std::string_view format, civil_time &ct) {
+  for (size_t i = 0; i < format.size(); i++) {
+    if (format[i] != '%') {
+      if (p == end or *p != format[i]) {
+        return false;
+      }
+      p++;
+      continue;
+    }
+    if (++i == format.size()) {
+      return false;
+    }
+    bool parsed = false;
+    switch (format[i]) {
+    case 'Y':
+      parsed = parse_digits(p, end, 4, ct.year);
+      break;
+    case 'm':
+      parsed = parse_digits(p, end, 2, ct.month) and ct.month >= 1 and ct.month <= 12;
+      break;
+    case 'd':
+      parsed = parse_digits(p, end, 2, ct.day) and ct.day >= 1 and ct.day <= 31;
+      break;
+    case 'H':
+      parsed = parse_digits(p, end, 2, ct.hour) and ct.hour <= 23;
+      break;
+    case 'M':
+      parsed = parse_digits(p, end, 2, ct.minute) and ct.minute <= 59;
+      break;
+    case 'S':
+      parsed = parse_digits(p, end, 2, ct.second) and ct.second <= 60;
+      break;
+    case 'N':
+      parsed = parse_digits(p, end, 9, ct.nano);
+      break;
+    case 'F':
+      parsed = parse_fields(p, end, "%Y-%m-%d", ct);
+      break;
+    case 'T':
+      parsed = parse_fields(p, end, "%H:%M:%S", ct);
+      break;
+    default:
+      break;
+    }
+    if (not parsed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Same as std::mktime on the start of given day, cached because parsed timestamps mostly fall on the same day.
+ * tm_isdst is 0 as in the slow path, so seconds within the day can be added linearly.
+ */
+static int64_t local_day_start(int64_t year, int64_t month, int64_t day) {
+  thread_local int64_t cached_key = -1;
+  thread_local int64_t cached_start = 0;
+  auto key = (year * 100 + month) * 100 + day;
+  if (key != cached_key) {
+    std::tm tm = {};
+    tm.tm_year = int(year) - 1900;
+    tm.tm_mon = int(month) - 1;
+    tm.tm_mday = int(day);
+    cached_start = std::mktime(&tm);
+    cached_key = key;
+  }
+  return cached_start;
+}
+
+static int64_t slow_strptime(const std::string &time_string, const std::string &format) {
   int64_t nano = 0;
   std::string normal_timestr = time_string;
   std::string normal_format = format;
@@ -94,6 +375,18 @@ int64_t time::strptime(const std::string &time_string, const std::string &format
   return duration_cast<nanoseconds>(tp_system.time_since_epoch()).count() + nano;
 }
 
+int64_t time::strptime(const std::string &time_string, const std::string &format) {
+  civil_time ct = {};
+  const char *p = time_string.data();
+  const char *end = p + time_string.size();
+  if (not parse_fields(p, end, format, ct) or p != end) {
+    return slow_strptime(time_string, format);
+  }
+  auto seconds = local_day_start(ct.year, ct.month, ct.day) + ct.hour * time_unit::SECONDS_PER_HOUR +
+                 ct.minute * time_unit::SECONDS_PER_MINUTE + ct.second;
+  return seconds * time_unit::NANOSECONDS_PER_SECOND + ct.nano;
+}
+
 int64_t time::strptime(const std::string &time_string, std::initializer_list<std::string> formats) {
   for (const auto &format : formats) {
     auto t = strptime(time_string, format);
@@ -104,10 +397,90 @@ int64_t time::strptime(const std::string &time_string, std::initializer_list<std
   return -1;
 }
 
+static void append_digits(std::string &out, int64_t value, int width) {
+  char buffer[20];
+  for (int i = width - 1; i >= 0; i--, value /= 10) {
+    buffer[i] = char('0' + value % 10);
+  }
+  out.append(buffer, width);
+}
+
+static bool format_fields(std::string &out, std::string_view format, const civil_time &ct) {
+  for (size_t i = 0; i < format.size(); i++) {
+    if (format[i] != '%') {
+      out.push_back(format[i]);
+      continue;
+    }
+    if (++i == format.size()) {
+      return false;
+    }
+    switch (format[i]) {
+    case 'Y':
+      append_digits(out, ct.year, 4);
+      break;
+    case 'm':
+      append_digits(out, ct.month, 2);
+      break;
+    case 'd':
+      append_digits(out, ct.day, 2);
+      break;
+    case 'H':
+      append_digits(out, ct.hour, 2);
+      break;
+    case 'M':
+      append_digits(out, ct.minute, 2);
+      break;
+    case 'S':
+      append_digits(out, ct.second, 2);
+      break;
+    case 'N':
+      append_digits(out, ct.nano, 9);
+      break;
+    case 'F':
+      format_fields(out, "%Y-%m-%d", ct);
+      break;
+    case 'T':
+      format_fields(out, "%H:%M:%S", ct);
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Same as std::localtime, cached per minute because offset changes of time zones only happen at minute boundaries.
+ */
+static civil_time local_civil_time(int64_t nanotime) {
+  thread_local int64_t cached_minute = -1;
+  thread_local civil_time cached = {};
+  auto seconds = nanotime / time_unit::NANOSECONDS_PER_SECOND;
+  auto minute = seconds / time_unit::SECONDS_PER_MINUTE;
+  if (minute != cached_minute) {
+    std::time_t minute_start = minute * time_unit::SECONDS_PER_MINUTE;
+    auto tm = *std::localtime(&minute_start);
+    cached = {tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, 0, 0};
+    cached_minute = minute;
+  }
+  civil_time ct = cached;
+  ct.second = seconds % time_unit::SECONDS_PER_MINUTE;
+  ct.nano = nanotime % time_unit::NANOSECONDS_PER_SECOND;
+  return ct;
+}
+
 std::string time::strftime(int64_t nanotime, const std::string &format) {
   if (nanotime == INT64_MAX) {
     return "end of world";
   }
+  if (nanotime > 0) {
+    std::string result = {};
+    result.reserve(format.size() + 32);
+    if (format_fields(result, format, local_civil_time(nanotime))) {
+      return result;
+    }
+  }
+
   time_point<steady_clock> tp_steady((nanoseconds(nanotime)));
   auto tp_epoch_steady = time_point<steady_clock>{};
   auto tp_diff = tp_steady - tp_epoch_steady;
@@ -117,21 +490,22 @@ std::string time::strftime(int64_t nanotime, const std::string &format) {
       system_clock::to_time_t(tp_epoch_system + duration_cast<system_clock::duration>(tp_diff));
 
   std::string normal_format = format;
-  std::regex nano_format_regex("%N");
-  if (std::regex_search(format, nano_format_regex)) {
-    int64_t nano = tp_diff.count() % time_unit::NANOSECONDS_PER_SECOND;
-    normal_format = std::regex_replace(format, nano_format_regex, fmt::format("{:09d}", nano));
+  auto nano_pos = normal_format.find("%N");
+  if (nano_pos != std::string::npos) {
+    auto nano = fmt::format("{:09d}", tp_diff.count() % time_unit::NANOSECONDS_PER_SECOND);
+    for (; nano_pos != std::string::npos; nano_pos = normal_format.find("%N", nano_pos + nano.size())) {
+      normal_format.replace(nano_pos, 2, nano);
+    }
   }
 
   std::ostringstream oss;
   oss << std::put_time(std::localtime(&time_since_epoch), normal_format.c_str());
-  if (nanotime > 0) {
-    return oss.str();
-  } else if (nanotime == 0) {
-    return std::regex_replace(oss.str(), std::regex("\\d"), "0");
-  } else {
-    return std::regex_replace(oss.str(), std::regex("\\d"), "#");
+  auto result = oss.str();
+  if (nanotime <= 0) {
+    auto mask = nanotime == 0 ? '0' : '#';
+    std::replace_if(result.begin(), result.end(), [](char c) { return c >= '0' and c <= '9'; }, mask);
   }
+  return result;
 }
 
 std::string time::strfnow(const std::string &format) { return strftime(now_in_nano(), format); }
@@ -151,6 +525,10 @@ void time::reset(int64_t system_clock_count, int64_t steady_clock_count) {
 time::time() : base_() {
   base_.system_clock_count = system_clock_count();
   base_.steady_clock_count = steady_clock_count();
+  auto source = std::getenv(CLOCK_SOURCE_ENV);
+  if (source != nullptr and std::string(source) == "tsc") {
+    set_clock_source(clock_source::tsc);
+  }
 }
 
 const time &time::get_instance() {
@@ -121,10 +121,41 @@ class PrioritizedCommandGroup(click.Group):
 @click.option(
     "-i", "--cli_dev_path", type=str, help="cli entry path (cli.dev.js or index.js)"
 )
+@click.option(
+    "--cpu-affinity",
+    type=str,
+    help="cpus to pin the event loop to, e.g. 2, 2,3 or 2-5,8",
+)
+@click.option(
+    "--aux-cpu-affinity",
+    type=str,
+    help="cpus to pin all other threads of the process to, e.g. 0-1",
+)
+@click.option(
+    "--rt-priority",
+    type=click.IntRange(1, 99),
+    help="run the event loop with SCHED_FIFO of given priority, linux only",
+)
+@click.option(
+    "--mlock",
+    is_flag=True,
+    help="lock process memory and journal pages for writing, needs ulimit -l, linux only",
+)
 @click.help_option("-h", "--help")
 @click.version_option(kungfu.__version__, "--version", message=kungfu.__version__)
 @click.pass_context
-def kfc(ctx, home, extension_path, log_level, name, cli_dev_path):
+def kfc(
+    ctx,
+    home,
+    extension_path,
+    log_level,
+    name,
+    cli_dev_path,
+    cpu_affinity,
+    aux_cpu_affinity,
+    rt_priority,
+    mlock,
+):
     if not home:
         osname = platform.system()
         user_home = os.path.expanduser("~")
@@ -147,6 +178,16 @@ def kfc(ctx, home, extension_path, log_level, name, cli_dev_path):
     os.environ["KF_HOME"] = ctx.home = home
     os.environ["KF_LOG_LEVEL"] = ctx.log_level = log_level
 
+    # thread placement is applied by apps on run, see os::apply_thread_placement
+    if cpu_affinity:
+        os.environ["KF_CPU_AFFINITY"] = cpu_affinity
+    if aux_cpu_affinity:
+        os.environ["KF_AUX_CPU_AFFINITY"] = aux_cpu_affinity
+    if rt_priority:
+        os.environ["KF_RT_PRIORITY"] = str(rt_priority)
+    if mlock:
+        os.environ["KF_MLOCK"] = "on"
+
     def ensure_dir(ctx, name):
         target = os.path.join(ctx.home, name)
         if not os.path.exists(target):
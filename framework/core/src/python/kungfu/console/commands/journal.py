@@ -112,12 +112,14 @@ def sessions(ctx, sortby, ascending, tablefmt):
 
 
 @journal.command()
+@click.option("-F", "--full", is_flag=True, help="drop all sessions and rescan")
+@click.option("-t", "--threads", type=int, default=0, help="worker threads")
 @journal_command_context
-def rebuild_index(ctx):
+def rebuild_index(ctx, full, threads):
     io_device = yjj.io_device(ctx.console_location)
     session_builder = yjj.session_builder(io_device)
     click.echo("rebuild sqlite db")
-    session_builder.rebuild_index_db()
+    session_builder.rebuild_index_db(not full, threads)
     click.echo("done")
 
 
@@ -254,6 +256,47 @@ def archive(ctx, format, mode):
     ctx.logger.info("archive done")
 
 
+@journal.command("export-columnar")
+@click.option("-o", "--output", type=str, required=True, help="output directory")
+@click.option(
+    "-t",
+    "--types",
+    type=str,
+    default="Quote,Entrust,Transaction",
+    help="comma separated longfist type names",
+)
+@click.option(
+    "-b", "--begin", type=str, default="", help=f"begin time, {SESSION_DATETIME_FORMAT}"
+)
+@click.option(
+    "-e", "--end", type=str, default="", help=f"end time, {SESSION_DATETIME_FORMAT}"
+)
+@click.option(
+    "-i", "--instruments", type=str, default="", help="comma separated instrument ids"
+)
+@click.option(
+    "-j", "--threads", type=int, default=0, help="worker threads, 0 for all cores"
+)
+@journal_command_context
+def export_columnar(ctx, output, types, begin, end, instruments, threads):
+    begin_time = yjj.strptime(begin, SESSION_DATETIME_FORMAT) if begin else 0
+    end_time = yjj.strptime(end, SESSION_DATETIME_FORMAT) if end else 2**63 - 1
+    rows = yjj.export_columnar(
+        ctx.runtime_locator,
+        output,
+        [t for t in types.split(",") if t],
+        begin_time,
+        end_time,
+        [i for i in instruments.split(",") if i],
+        ctx.mode,
+        ctx.category,
+        ctx.group,
+        ctx.name,
+        threads,
+    )
+    click.echo(f"exported {rows} rows to {output}")
+
+
 @journal.command("list-archive")
 @journal_command_context
 def list_archive(ctx):
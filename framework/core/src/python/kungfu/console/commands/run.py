@@ -111,12 +111,35 @@ def ledger(ctx, replay, session_id):
     "--time-interval",
     default="1m",
     type=str,
-    help="bar time interval, s/m/h/d, s=Second m=Minute h=Hour d=Day",
+    help="bar time intervals separated by comma, s/m/h/d, s=Second m=Minute h=Hour d=Day, e.g. 1s,1m,5m",
+)
+@click.option(
+    "-v",
+    "--volume-interval",
+    type=str,
+    help="bar volume thresholds separated by comma",
+)
+@click.option(
+    "-u",
+    "--turnover-interval",
+    type=str,
+    help="bar turnover thresholds separated by comma",
+)
+@click.option(
+    "-k",
+    "--tick-source",
+    default="quote",
+    type=click.Choice(["quote", "transaction"]),
+    help="ticks to build bars from",
 )
 @service_command_context
-def bar(ctx, source, time_interval):
+def bar(ctx, source, time_interval, volume_interval, turnover_interval, tick_source):
     ctx.mode = lf.enums.mode.LIVE
-    args = {"source": source, "time_interval": time_interval}
+    args = {"source": source, "time_interval": time_interval, "tick_source": tick_source}
+    if volume_interval:
+        args["volume_interval"] = volume_interval
+    if turnover_interval:
+        args["turnover_interval"] = turnover_interval
     instance = wc.BarGenerator(
         ctx.runtime_locator, ctx.mode, ctx.low_latency, json.dumps(args)
     )
@@ -71,6 +71,18 @@ class Strategy(wc.Strategy):
         self._on_transaction = getattr(
             self._module, "on_transaction", lambda ctx, transaction, location: None
         )
+        # batch callbacks are optional, defining any of them turns on batched delivery of market data
+        self._on_market_data = getattr(self._module, "on_market_data", None)
+        self._on_quotes = getattr(self._module, "on_quotes", None)
+        self._on_entrusts = getattr(self._module, "on_entrusts", None)
+        self._on_transactions = getattr(self._module, "on_transactions", None)
+        # a batch is only valid during the call, an async callback would run too late
+        for name in ["on_market_data", "on_quotes", "on_entrusts", "on_transactions"]:
+            if inspect.iscoroutinefunction(getattr(self._module, name, None)):
+                raise TypeError(
+                    f"{name} of strategy {path} can not be async, "
+                    f"copy the batch into a list and hand it to a coroutine instead"
+                )
         self._on_order = getattr(
             self._module, "on_order", lambda ctx, order, location: None
         )
@@ -223,6 +235,13 @@ class Strategy(wc.Strategy):
         self.ctx.is_positions_mirrored = wc_context.is_positions_mirrored
         self.ctx.is_bypass_accounting = wc_context.is_bypass_accounting
         self.ctx.bypass_accounting = wc_context.bypass_accounting
+        self.ctx.conflate_quotes = wc_context.conflate_quotes
+        self.ctx.get_quote_conflation_threshold = (
+            wc_context.get_quote_conflation_threshold
+        )
+        self.ctx.get_conflated_quote_count = wc_context.get_conflated_quote_count
+        self.ctx.batch_market_data = wc_context.batch_market_data
+        self.ctx.is_market_data_batched = wc_context.is_market_data_batched
         self.ctx.hold_book = wc_context.hold_book
         self.ctx.hold_positions = wc_context.hold_positions
         self.ctx.get_account_book = self.__get_account_book
@@ -231,6 +250,13 @@ class Strategy(wc.Strategy):
         self.ctx.buy = functools.partial(self.__async_insert_order, Side.Buy)
         self.ctx.sell = functools.partial(self.__async_insert_order, Side.Sell)
         self.__init_book()
+        if (
+            self._on_market_data
+            or self._on_quotes
+            or self._on_entrusts
+            or self._on_transactions
+        ):
+            wc_context.batch_market_data()
         self.__call_proxy(self._pre_start, self.ctx)
 
     def post_start(self, wc_context):
@@ -257,6 +283,31 @@ class Strategy(wc.Strategy):
     def on_transaction(self, wc_context, transaction, location):
         self.__call_proxy(self._on_transaction, self.ctx, transaction, location)
 
+    def __call_batch(self, func, fallback, wc_context, batch):
+        # batch is only valid during this call, per item callbacks get copies
+        if func:
+            func(self.ctx, batch)
+        else:
+            fallback(self, wc_context, batch)
+
+    def on_market_data(self, wc_context, batch):
+        self.__call_batch(
+            self._on_market_data, wc.Strategy.on_market_data, wc_context, batch
+        )
+
+    def on_quotes(self, wc_context, quotes):
+        self.__call_batch(self._on_quotes, wc.Strategy.on_quotes, wc_context, quotes)
+
+    def on_entrusts(self, wc_context, entrusts):
+        self.__call_batch(
+            self._on_entrusts, wc.Strategy.on_entrusts, wc_context, entrusts
+        )
+
+    def on_transactions(self, wc_context, transactions):
+        self.__call_batch(
+            self._on_transactions, wc.Strategy.on_transactions, wc_context, transactions
+        )
+
     def on_order(self, wc_context, order, location):
         self.__call_proxy(self._on_order, self.ctx, order, location)
 
@@ -0,0 +1,23 @@
+#  SPDX-License-Identifier: Apache-2.0
+
+import json
+import numpy
+import os
+
+
+def load(path, mmap_mode="r"):
+    """Load columns written by yjj.columnar_sink under path/{type_name}, returns dict of field name to numpy array"""
+    with open(os.path.join(path, "schema.json"), "r") as schema_file:
+        schema = json.load(schema_file)
+    rows = schema["rows"]
+    return {
+        column["name"]: numpy.memmap(
+            os.path.join(path, column["file"]),
+            dtype=numpy.dtype(column["dtype"]),
+            mode=mmap_mode,
+            shape=(rows, *column["shape"]),
+        )
+        if rows > 0
+        else numpy.empty((0, *column["shape"]), dtype=numpy.dtype(column["dtype"]))
+        for column in schema["columns"]
+    }